@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+
+// ----------------------------------------------------------
+// Звуковой движок на одном канале LEDC.
+//
+// loop() только ставит ноты и мелодии в очередь (кольцо без
+// блокировок); играет их обратный вызов периодического таймера
+// esp_timer: он отсчитывает длительности, ведёт огибающую
+// скважности (нарастание/спад) и выключает звук в паузах.
+// Поэтому ритм мелодии не зависит от загрузки loop() и отрисовки.
+// Таймер работает, только пока есть что играть.
+// ----------------------------------------------------------
+
+namespace Melodies {
+struct Melody;
+}
+
+namespace Audio {
+
+struct Note {
+  uint16_t frequency;  // Гц; 0 - пауза
+  uint16_t gateMs;     // сколько из durationMs нота звучит
+  uint16_t durationMs; // шаг до следующей ноты
+  uint8_t  attackMs;   // нарастание скважности от нуля
+  uint8_t  releaseMs;  // спад к концу gateMs
+};
+
+// Короткий сигнал без огибающей (клик, тик анимации, тревога)
+constexpr Note beep(uint16_t frequency, uint16_t durationMs) {
+  return {frequency, durationMs, durationMs, 0, 0};
+}
+
+// Канал LEDC на выводе пищалки и таймер движка
+void begin(uint8_t pin);
+
+// Поставить в очередь; false - очередь полна
+bool play(const Note& note);
+
+// Мелодия из Melodies::LIBRARY (темп уже применён при компиляции)
+// с паузой NOTE_PAUSE_BETWEEN и огибающей MELODY_ATTACK/RELEASE_MS.
+// Мелодия должна жить всё время проигрывания (таблица - во flash)
+bool playMelody(const Melodies::Melody& melody);
+
+// Оборвать текущий звук и всё, что было поставлено до этого вызова
+void stop();
+
+// Идёт ли воспроизведение
+bool busy();
+
+} // namespace Audio
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <Adafruit_ST7735.h>
+
+#include "config.h"
+#include "render_target.h"
+#include "st7735_display.h"
+
+// ----------------------------------------------------------
+// Полоса экрана BAND_ROWS x WIDTH в RGB565 для кадров, которые
+// перекрывают весь экран. Сцена (те же функции отрисовки, что
+// рисуют на дисплей) прогоняется по разу на каждую полосу;
+// примитивы отсекаются по её строкам и пишут в память, а готовая
+// полоса уходит на панель одним окном прямо из буфера через DMA.
+// Буферов два: пока DMA отправляет один, CPU рисует следующую
+// полосу в другой. Пиксели хранятся уже в порядке линии (big-endian).
+// ----------------------------------------------------------
+
+class BandTarget : public RenderTarget {
+public:
+  static constexpr uint16_t WIDTH   = Config::Display::WIDTH;
+  static constexpr uint16_t HEIGHT  = Config::Display::HEIGHT;
+  static constexpr uint16_t ROWS    = Config::Display::BAND_ROWS;
+  static constexpr uint8_t  COUNT   = HEIGHT / ROWS;
+  static constexpr uint8_t  BUFFERS = 2;
+
+  static_assert(HEIGHT % ROWS == 0, "Высота экрана должна делиться на BAND_ROWS");
+
+  BandTarget();
+
+  // Начать полосу band: следующий буфер (ждёт, пока DMA его дочитает)
+  void beginBand(St7735Display& panel, uint8_t band);
+
+  // Отправить полосу на панель без копирования
+  void sendBand(St7735Display& panel);
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void writePixel(int16_t x, int16_t y, uint16_t color) override;
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) override;
+  void pushPixels(const uint16_t* pixels, uint32_t count) override;
+  void pushColor(uint16_t color, uint32_t count) override;
+
+private:
+  // Память только в режиме полос (Config::Display::BANDED)
+  static constexpr uint16_t BUFFER_ROWS = Config::Display::BANDED ? ROWS : 1;
+
+  void fillSpan(int16_t x, int16_t y, int16_t w, uint16_t wireColor);
+
+  alignas(4) uint16_t pixels[BUFFERS][WIDTH * BUFFER_ROWS];
+  uint32_t fence[BUFFERS] = {};
+  uint8_t  active = 0;
+  int16_t  bandY  = 0;
+
+  // Окно потоковой записи
+  uint16_t windowX = 0;
+  uint16_t windowY = 0;
+  uint16_t windowW = 0;
+  uint16_t windowH = 0;
+  uint32_t windowPos = 0;
+};
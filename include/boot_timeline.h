@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+
+class Print;
+
+// ----------------------------------------------------------
+// Хронология загрузки.
+//
+// Каждый этап setup() (и задачи отрисовки - инициализация панели,
+// первый кадр) отмечает момент своего завершения по esp_timer,
+// то есть от сброса чипа. Отметка ставится один раз, из любой
+// задачи. В конце загрузки отчёт уходит в Serial: этапы по
+// времени, прирост от предыдущего и главное - от сброса до
+// первого кадра на панели.
+// ----------------------------------------------------------
+
+namespace BootTimeline {
+
+enum class Stage : uint8_t {
+  SetupStart,   // вход в setup()
+  SerialPort,   // Serial готов
+  Audio,        // пищалка и звуковой таймер
+  Scheduler,    // планировщик и задачи loop()
+  Button,       // кнопка и прерывание
+  RenderTask,   // задача отрисовки запущена
+  PanelReady,   // панель проинициализирована (задача отрисовки)
+  Nvs,          // NVS открыт, история загружена
+  Rng,          // генератор бросков засеян
+  IntroPosted,  // интро поставлено в очередь
+  FirstFrame,   // первый кадр отправлен на панель (задача отрисовки)
+  Ready,        // setup() завершён
+  COUNT
+};
+
+// Отметить завершение этапа сейчас; повторная отметка игнорируется
+void mark(Stage stage);
+
+// Момент этапа, мкс от сброса; 0 - ещё не отмечен
+uint32_t atUs(Stage stage);
+
+// Этапы в порядке времени и от сброса до первого кадра
+void report(Print& out);
+
+} // namespace BootTimeline
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+
+// ----------------------------------------------------------
+// Кнопка на прерываниях. ISR только ставит фронт с отметкой
+// esp_timer в кольцо и будит loop(); антидребезг и распознавание
+// жестов выполняет poll() уже вне прерывания, по отметкам времени
+// фронтов, а не по моменту, когда loop() до них добрался.
+// Антидребезг по переднему фронту: переход засчитывается по
+// первому фронту, дребезг следующих DEBOUNCE_MS отбрасывается.
+//
+// Короткое нажатие выдаётся сразу при отпускании; если следующее
+// нажатие началось в пределах DOUBLE_CLICK_MS, его отпускание даёт
+// DoubleClick вместо второго ShortPress. LongPress - в момент
+// достижения LONG_PRESS_MS, не дожидаясь отпускания.
+// ----------------------------------------------------------
+
+namespace ButtonInput {
+
+enum class Gesture : uint8_t { ShortPress, LongPress, DoubleClick };
+
+struct Event {
+  Gesture  gesture;
+  uint64_t edgeUs; // фронт (или порог долгого нажатия), породивший событие
+};
+
+struct LatencyStats {
+  uint32_t events;
+  uint32_t maxUs;
+  uint64_t totalUs;
+  uint32_t droppedEdges; // фронты, не поместившиеся в кольцо
+};
+
+// Настроить вход и повесить прерывание на оба фронта
+void begin(uint8_t pin);
+
+// Разобрать накопленные фронты и пороги времени до nowUs
+void poll(uint64_t nowUs);
+
+// Следующее распознанное событие; false - событий нет
+bool nextEvent(Event& event);
+
+// Ближайший момент, когда poll() что-то решит без новых фронтов
+// (конец антидребезга, порог долгого нажатия); 0 - такого нет
+uint64_t nextDeadlineUs();
+
+// Учёт задержки от фронта до обработчика события
+void recordLatency(const Event& event, uint64_t handledUs);
+const LatencyStats& latencyStats();
+
+const char* gestureName(Gesture gesture);
+
+} // namespace ButtonInput
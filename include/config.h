@@ -17,6 +17,22 @@ namespace Hardware {
 
   inline constexpr uint8_t BUTTON_PIN = 15;
   inline constexpr uint8_t BUZZER_PIN = 13;
+
+  // Шина дисплея:
+  //  SoftSpi - программный SPI (ногодрыг), как в исходной версии;
+  //  VspiDma - аппаратный VSPI с очередью DMA-транзакций.
+  enum class TftBusType : uint8_t { SoftSpi, VspiDma };
+  inline constexpr TftBusType TFT_BUS = TftBusType::VspiDma;
+
+  // Частота SPI. Пины 18/23/5 - родные пины VSPI (IO_MUX),
+  // поэтому допустимо до 40 МГц на коротких проводах; 27 МГц - надёжный вариант.
+  inline constexpr uint32_t TFT_SPI_FREQ_HZ = 27000000;
+
+  // Размер одного DMA-буфера в пикселях (буферов два, работают по очереди)
+  inline constexpr uint16_t TFT_DMA_CHUNK_PIXELS = 1024;
+
+  // Глубина очереди SPI-транзакций
+  inline constexpr uint8_t  TFT_DMA_QUEUE_DEPTH  = 8;
 }
 
 namespace Display {
@@ -29,6 +45,49 @@ namespace Display {
 
   // Ориентация экрана (0..3)
   inline constexpr uint8_t ROTATION   = 1;
+
+  // Рисовать в теневой кадр (4 бита/пиксель, 10 КБ плюс 512 байт
+  // масок изменений) и отправлять на панель только изменившиеся
+  // куски строк
+  inline constexpr bool USE_SHADOW_FRAMEBUFFER = true;
+
+  // Без теневого кадра: кадры, перекрывающие весь экран (очистка перед
+  // броском, первый кадр таймера, алерт), собираются полосами по
+  // BAND_ROWS строк в двух буферах RGB565 (2 x 160 x 16 x 2 = 10 КБ):
+  // DMA отправляет одну полосу, пока CPU рисует следующую, и каждый
+  // пиксель уходит на шину один раз
+  inline constexpr bool     USE_BAND_RENDERER = true;
+  inline constexpr uint16_t BAND_ROWS         = 16;
+  inline constexpr bool     BANDED            = USE_BAND_RENDERER && !USE_SHADOW_FRAMEBUFFER;
+}
+
+namespace Render {
+  // Отрисовка выполняется отдельной задачей FreeRTOS на другом ядре,
+  // loop() только ставит команды в очередь (размер - степень двойки)
+  inline constexpr uint16_t QUEUE_SIZE    = 32;
+
+  // loop() Arduino работает на ядре 1, отрисовка - на ядре 0
+  inline constexpr uint8_t  TASK_CORE     = 0;
+  inline constexpr uint8_t  TASK_PRIORITY = 2;
+  inline constexpr uint32_t TASK_STACK    = 4096;
+}
+
+namespace Log {
+  // Журнал событий (event_log.h): двоичные записи в кольце RAM, в Serial
+  // их выводит отдельная задача с низким приоритетом
+  enum class Level : uint8_t { Debug, Info, Warn, Error, Off };
+
+  // События ниже порога не компилируются вовсе (вместе с аргументами)
+  inline constexpr Level    LEVEL = Level::Info;
+
+  // Записей в кольце (степень двойки); при переполнении новые отбрасываются и считаются
+  inline constexpr uint16_t RING_SIZE = 64;
+
+  // Задача вывода: ниже отрисовки, опрос кольца раз в DRAIN_PERIOD_MS
+  inline constexpr uint8_t  TASK_CORE       = 0;
+  inline constexpr uint8_t  TASK_PRIORITY   = 1;
+  inline constexpr uint32_t TASK_STACK      = 2048;
+  inline constexpr uint32_t DRAIN_PERIOD_MS = 20;
 }
 
 namespace Colors {
@@ -61,54 +120,91 @@ namespace Colors {
 }
 
 namespace Dice {
-  // Геометрия кубиков
-  inline constexpr uint16_t SIZE       = 70;  // размер кубика в пикселях
-  inline constexpr uint16_t RADIUS     = 10;  // радиус закругления углов
-  inline constexpr uint16_t DOT_RADIUS = 7;   // радиус точек на кубике
-
-  // Базовый "равномерный" отступ, исходя из требования:
-  // [margin][cube][margin][cube][margin] по ширине экрана.
-  // 2*SIZE + 3*margin ≈ Display::WIDTH
-  inline constexpr int16_t BASE_MARGIN =
-      static_cast<int16_t>((static_cast<int16_t>(Config::Display::WIDTH)
-                           - static_cast<int16_t>(2 * SIZE)) / 3);
-
-  // Остаток от деления (для равномерного распределения погрешности, максимум ±1 пиксель)
-  inline constexpr int16_t REMAINDER =
-      static_cast<int16_t>(
-        static_cast<int16_t>(Config::Display::WIDTH)
-        - static_cast<int16_t>(2 * SIZE)
-        - static_cast<int16_t>(3 * BASE_MARGIN)
-      );
-
-  // Левый отступ
-  inline constexpr int16_t MARGIN_LEFT =
-      static_cast<int16_t>(BASE_MARGIN + (REMAINDER > 0 ? 1 : 0));
-
-  // Расстояние между кубиками
-  inline constexpr int16_t SPACING =
-      static_cast<int16_t>(BASE_MARGIN + (REMAINDER > 1 ? 1 : 0));
-
-  // Правый отступ (для контроля, чтобы сумма сходилась)
-  inline constexpr int16_t MARGIN_RIGHT =
-      static_cast<int16_t>(
-        static_cast<int16_t>(Config::Display::WIDTH)
-        - static_cast<int16_t>(2 * SIZE)
-        - MARGIN_LEFT
-        - SPACING
-      );
-
-  // Координаты кубиков с учетом равномерных отступов
-  inline constexpr int16_t DICE1_X = MARGIN_LEFT;
-  inline constexpr int16_t DICE1_Y =
-      static_cast<int16_t>(
-        (static_cast<int16_t>(Config::Display::HEIGHT)
-         - static_cast<int16_t>(SIZE)) / 2
-      );
-
-  inline constexpr int16_t DICE2_X =
-      static_cast<int16_t>(DICE1_X + static_cast<int16_t>(SIZE) + SPACING);
-  inline constexpr int16_t DICE2_Y = DICE1_Y;
+  // Набор костей на столе: число кубиков и граней (d4..d20)
+  inline constexpr uint8_t COUNT = 2;
+  inline constexpr uint8_t FACES = 6;
+
+  // Наименьший зазор между кубиками и до края экрана
+  inline constexpr int16_t MIN_GAP = 6;
+
+  // Раскладка N кубиков размера S на панели W x H: ряды сверху вниз,
+  // в каждом ряду - равные отступы [margin][cube][margin]...[cube][margin],
+  // остаток деления уходит в левый отступ и шаг (максимум ±1 пиксель).
+  // Неполный последний ряд центрируется своими отступами
+  template <uint8_t N>
+  struct Layout {
+    int16_t x[N];
+    int16_t y[N];
+    uint8_t rows;
+    uint8_t cols;
+    bool    fits;
+  };
+
+  // Первый отступ и шаг для k кубиков размера size на отрезке total
+  struct Spread {
+    int16_t first;
+    int16_t step;
+  };
+
+  constexpr Spread spread(int16_t k, int16_t total, int16_t size) {
+    const int16_t base      = static_cast<int16_t>((total - k * size) / (k + 1));
+    const int16_t remainder = static_cast<int16_t>(total - k * size - (k + 1) * base);
+    return {static_cast<int16_t>(base + (remainder > 0 ? 1 : 0)),
+            static_cast<int16_t>(size + base + (remainder > 1 ? 1 : 0))};
+  }
+
+  template <uint8_t N, int16_t W, int16_t H, int16_t S>
+  constexpr Layout<N> makeLayout() {
+    static_assert(N >= 1, "Нужен хотя бы один кубик");
+    Layout<N> layout{};
+
+    // Наименьшее число рядов, при котором ряд влезает по ширине
+    uint8_t rows = 1;
+    while (rows < N && ((N + rows - 1) / rows) * (S + MIN_GAP) + MIN_GAP > W) {
+      ++rows;
+    }
+    const uint8_t cols = static_cast<uint8_t>((N + rows - 1) / rows);
+    layout.rows = rows;
+    layout.cols = cols;
+    layout.fits = cols * (S + MIN_GAP) + MIN_GAP <= W && rows * (S + MIN_GAP) + MIN_GAP <= H;
+
+    const Spread vertical = spread(rows, H, S);
+    for (uint8_t i = 0; i < N; ++i) {
+      const uint8_t row    = static_cast<uint8_t>(i / cols);
+      const uint8_t column = static_cast<uint8_t>(i % cols);
+      const uint8_t inRow  = static_cast<uint8_t>(row + 1 < rows ? cols : N - row * cols);
+      const Spread horizontal = spread(inRow, W, S);
+      layout.x[i] = static_cast<int16_t>(horizontal.first + column * horizontal.step);
+      layout.y[i] = static_cast<int16_t>(vertical.first + row * vertical.step);
+    }
+    return layout;
+  }
+
+  // Самый крупный кубик, при котором N кубиков помещаются на панели
+  constexpr int16_t largestSize(uint8_t n, int16_t width, int16_t height) {
+    int16_t best = 0;
+    for (uint8_t rows = 1; rows <= n; ++rows) {
+      const int16_t cols = static_cast<int16_t>((n + rows - 1) / rows);
+      const int16_t byW  = static_cast<int16_t>((width - (cols + 1) * MIN_GAP) / cols);
+      const int16_t byH  = static_cast<int16_t>((height - (rows + 1) * MIN_GAP) / rows);
+      const int16_t size = byW < byH ? byW : byH;
+      best = size > best ? size : best;
+    }
+    return best;
+  }
+
+  // Геометрия кубиков: пара - исходные 70 пикселей, больше - сколько влезет
+  inline constexpr uint16_t SIZE =
+      COUNT <= 2 ? 70 : static_cast<uint16_t>(largestSize(COUNT, Config::Display::WIDTH, Config::Display::HEIGHT));
+  inline constexpr uint16_t RADIUS     = SIZE / 7;   // радиус закругления углов (10 при 70)
+  inline constexpr uint16_t DOT_RADIUS = SIZE / 10;  // радиус точек на кубике (7 при 70)
+
+  // Координаты кубиков, посчитанные при компиляции
+  inline constexpr Layout<COUNT> LAYOUT =
+      makeLayout<COUNT, Config::Display::WIDTH, Config::Display::HEIGHT, SIZE>();
+
+  static_assert(FACES >= 2 && FACES <= 20, "Поддерживаются кости d2..d20");
+  static_assert(LAYOUT.fits, "Кубики не помещаются на экране: уменьшите COUNT или SIZE");
 }
 
 namespace Input {
@@ -118,8 +214,15 @@ namespace Input {
   // Время для регистрации долгого нажатия (в мс)
   inline constexpr uint32_t LONG_PRESS_MS   = 1500;
 
-  // Небольшая задержка в конце loop() для разгрузки CPU
-  inline constexpr uint32_t LOOP_IDLE_DELAY = 10;
+  // Второе нажатие не позже этого интервала после отпускания - двойной клик
+  inline constexpr uint32_t DOUBLE_CLICK_MS = 300;
+
+  // Очередь фронтов из прерывания кнопки (степень двойки)
+  inline constexpr uint16_t EDGE_QUEUE_SIZE = 32;
+
+  // Максимальный сон loop() без событий: он спит до ближайшего срока
+  // или фронта на кнопке, но хотя бы раз в интервал читает Serial
+  inline constexpr uint32_t MAX_IDLE_SLEEP_MS = 1000;
 }
 
 namespace Timer {
@@ -140,6 +243,14 @@ namespace Alert {
   // Интервал мигания в миллисекундах
   inline constexpr uint32_t BLINK_INTERVAL_MS = 500;
 
+  // Способ мигания:
+  //  Redraw       - попеременно очистка экрана и отрисовка треугольника (исходный вариант);
+  //  DisplayOnOff - треугольник рисуется один раз, мигание командами DISPOFF/DISPON;
+  //  Inversion    - треугольник рисуется один раз, мигание инверсией INVON/INVOFF.
+  // Командные режимы не передают пиксели: каждое мигание - один байт команды.
+  enum class BlinkMode : uint8_t { Redraw, DisplayOnOff, Inversion };
+  inline constexpr BlinkMode BLINK_MODE = BlinkMode::DisplayOnOff;
+
   // Геометрия треугольника (по отношению к экрану)
   inline constexpr int16_t TRI_TOP_Y             = 10;
   inline constexpr int16_t TRI_BOTTOM_MARGIN     = 10;
@@ -147,18 +258,84 @@ namespace Alert {
 }
 
 namespace Animation {
-  // Количество кадров анимации броска
-  inline constexpr uint8_t  ROLL_FRAMES    = 15;
-
-  // Задержка между кадрами (мс)
-  inline constexpr uint32_t FRAME_DELAY_MS = 50;
+  // Барабан слот-машины (reel_strip.h): лента граней едет через экран
+  // аппаратной прокруткой ST7735 (VSCRDEF/VSCRSADD). Кадр - команда
+  // сдвига и только въезжающие столбцы ленты, а не грани целиком.
+  // Ось прокрутки панели - её 160 строк развёртки, в ландшафте это ось x,
+  // поэтому барабан крутится по горизонтали: нужен один ряд кубиков,
+  // грани с точками (атлас) и панель 128x160 без смещения (BLACKTAB)
+  inline constexpr bool     REEL_SCROLL = false;
+  inline constexpr bool     REEL        = REEL_SCROLL && Dice::FACES <= 9 && Dice::LAYOUT.rows == 1 &&
+                                          (Display::ROTATION & 1) != 0 &&
+                                          Display::INITR_MODE == INITR_BLACKTAB;
+
+  // Оборотов ленты за бросок (по ширине экрана): итог встаёт на место
+  // кубиков ровно при нулевом сдвиге прокрутки
+  inline constexpr uint8_t  REEL_TURNS  = 2;
+
+  // Кувыркающиеся кубики: кадры берутся из атласа повёрнутых граней
+  // (tumble_atlas.h), а не сменой точек на неподвижном квадрате.
+  // Атлас есть только для граней с точками (до d9)
+  inline constexpr bool     TUMBLE_SPRITES = true;
+  inline constexpr bool     TUMBLE         = TUMBLE_SPRITES && Dice::FACES <= 9 && !REEL;
+
+  // Количество промежуточных кадров анимации броска
+  inline constexpr uint8_t  ROLL_FRAMES    = REEL ? 47 : TUMBLE ? 31 : 15;
+
+  // Средний шаг между кадрами (мс); кувырок - не реже 30 кадров в секунду,
+  // барабан - 60: кадр стоит сотни байт, а не грани целиком
+  inline constexpr uint32_t FRAME_DELAY_MS = REEL ? 16 : TUMBLE ? 25 : 50;
+
+  // Бюджет всего броска: промежуточные кадры + итог, не растягивается
+  inline constexpr uint32_t ROLL_DURATION_MS = (ROLL_FRAMES + 1) * FRAME_DELAY_MS;
+
+  // Замедление граней к концу броска: 0 - равномерно, 100 - шаг растёт
+  // линейно от нуля (кадр k из N в момент D * (k/N)^2)
+  // Барабан замедляется сам (позиция ленты по кривой), кадры идут ровно
+  inline constexpr uint8_t  EASE_OUT_PERCENT = REEL ? 0 : TUMBLE ? 30 : 50;
 
   // Очищать ли экран перед началом анимации
   inline constexpr bool     CLEAR_SCREEN_ON_START = true;
 }
 
+namespace Trace {
+  // Трасса loop() (loop_trace.h, флаг сборки -DLOOP_TRACE):
+  // сколько последних отрезков хранить в RAM (по 16 байт)
+  inline constexpr uint16_t SPANS = 256;
+
+  // Допуск опоздания относительно цели (мкс); больше - промах срока.
+  // Кадр броска - половина шага: позже движение заметно дёргается
+  inline constexpr uint32_t FRAME_MISS_US  = Animation::FRAME_DELAY_MS * 1000 / 2;
+
+  // Смена цифры таймера - не позже кадра при 50 Гц
+  inline constexpr uint32_t TIMER_MISS_US  = 20 * 1000;
+
+  // Мигание алерта - десятая часть интервала
+  inline constexpr uint32_t BLINK_MISS_US  = Alert::BLINK_INTERVAL_MS * 1000 / 10;
+
+  // Жест кнопки от фронта, породившего его
+  inline constexpr uint32_t BUTTON_MISS_US = 20 * 1000;
+
+  // Пробуждение loop() и разовые задачи (конец показа, запись истории)
+  inline constexpr uint32_t OTHER_MISS_US  = 5 * 1000;
+}
+
+namespace Boot {
+  // Быстрая загрузка: вместо фиксированных пауз Config::Intro::*_DELAY_MS
+  // setup() ждёт готовности (Serial, кадр интро на панели), панель
+  // инициализируется в задаче отрисовки одновременно с NVS и RNG,
+  // лишней очистки экрана перед интро нет
+  inline constexpr bool     FAST_BOOT = true;
+
+  // Сколько ждать готовности Serial (USB CDC без подключённого хоста)
+  inline constexpr uint32_t SERIAL_WAIT_MAX_MS = 100;
+
+  // Печатать хронологию загрузки (boot_timeline.h) в Serial
+  inline constexpr bool     REPORT_TIMELINE = true;
+}
+
 namespace Intro {
-  // Задержки в setup()
+  // Задержки в setup() (только при Boot::FAST_BOOT = false)
   inline constexpr uint32_t SERIAL_START_DELAY_MS  = 1000;
   inline constexpr uint32_t DISPLAY_INIT_DELAY_MS  = 100;
   inline constexpr uint32_t DISPLAY_CLEAR_DELAY_MS = 100;
@@ -181,6 +358,17 @@ namespace Intro {
 }
 
 namespace Sound {
+  // Звуковой движок: один канал LEDC; длительности и огибающую
+  // отсчитывает периодический таймер esp_timer с шагом TICK_US
+  inline constexpr uint8_t  LEDC_CHANNEL    = 0;
+  inline constexpr uint8_t  LEDC_RESOLUTION = 10;   // бит скважности
+  inline constexpr uint32_t TICK_US         = 1000;
+  inline constexpr uint16_t QUEUE_SIZE      = 16;   // степень двойки
+
+  // Огибающая нот мелодии (нарастание и спад скважности), мс
+  inline constexpr uint8_t  MELODY_ATTACK_MS  = 5;
+  inline constexpr uint8_t  MELODY_RELEASE_MS = 20;
+
   // Звук "клика" для каждого кадра анимации
   inline constexpr int ANIM_TICK_FREQ = 2200;
   inline constexpr int ANIM_TICK_DURATION = 20; // мс
@@ -193,30 +381,36 @@ namespace Sound {
   inline constexpr int BUTTON_CLICK_FREQ = 1500;
   inline constexpr int BUTTON_CLICK_DURATION = 50;
 
-#include "rock_1.h"
-
-  // --- Управление набором мелодий ---
-  // 1. Массив указателей на все мелодии
-  inline const int* const MELODIES[] = {
-    OMNI_STYLE_LOOP
-  };
-
-  // 2. Массив с количеством нот для каждой мелодии
-  inline constexpr int MELODY_NOTE_COUNTS[] = {
-    OMNI_STYLE_LOOP_SIZE
-  };
-  
-  // 3. Общее количество доступных мелодий
-  inline constexpr int TOTAL_MELODIES = sizeof(MELODIES) / sizeof(MELODIES[0]);
-
   // Звук подтверждения смены мелодии
   inline constexpr int CHANGE_MELODY_FREQ = 2500;
   inline constexpr int CHANGE_MELODY_DURATION = 100;
 
   inline constexpr int NOTE_PAUSE_BETWEEN = 50; // Пауза между нотами
 
-  // Коэффициент масштабирования темпа. 1.0 = оригинал, > 1.0 = медленнее, < 1.0 = быстрее.
-  inline constexpr float TEMPO_SCALE = 1.5f;
+  // Мелодии - в melodies.h; темп и транспонирование применяются
+  // к ним при компиляции.
+  // Темп в процентах от исходника. 100 = оригинал, > 100 = медленнее, < 100 = быстрее.
+  inline constexpr uint16_t TEMPO_PERCENT = 150;
+  // Транспонирование всех мелодий, полутоны
+  inline constexpr int8_t TRANSPOSE_SEMITONES = 0;
+}
+
+namespace History {
+  // Последние броски в RAM: 6 бит на бросок двух кубиков (кратно 4)
+  inline constexpr uint16_t CAPACITY = 64;
+
+  // Запись в NVS: после FLUSH_BATCH новых бросков (сразу по окончании
+  // анимации) или в простое - после IDLE_FLUSH_MS без бросков. Простой
+  // длиннее цикла результат + таймер: пока играют подряд, броски ждут
+  // в RAM пачки, а не пишутся по одному
+  inline constexpr uint16_t FLUSH_BATCH   = 8;
+  inline constexpr uint32_t IDLE_FLUSH_MS = 5 * 60 * 1000UL;
+
+  static_assert(IDLE_FLUSH_MS > (Timer::RESULT_DISPLAY_SEC + Timer::DURATION_SEC) * 1000UL,
+                "Простой должен быть длиннее показа результата и таймера");
+
+  // Ключ NVS в пространстве "dice-app"
+  inline constexpr const char* NVS_KEY = "history";
 }
 
 } // namespace Config
\ No newline at end of file
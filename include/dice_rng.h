@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+
+// ----------------------------------------------------------
+// Генератор бросков кубиков: xoshiro128** (32 бита на шаг,
+// родная разрядность ESP32) и приведение к диапазону по Лемиру
+// без смещения (умножение 32x32->64 вместо деления по модулю,
+// редкий повтор для отбрасываемого хвоста).
+//
+// Броски идут пачками: одно 32-битное число приводится к
+// диапазону faces^k и раскладывается на k цифр по основанию
+// faces - для d6 это 9 бросков за один шаг генератора.
+//
+// Засев - из аппаратного RNG (seedFromHardware) или
+// детерминированный (seed), чтобы хост-прогон мог повторить
+// точную последовательность бросков. Свободные функции работают
+// с общим генератором и вызываются только из loop(); у кого нужен
+// свой поток бросков (хост-проверка честности по потокам), тот
+// держит собственный Generator.
+// ----------------------------------------------------------
+
+namespace DiceRng {
+
+class Generator {
+public:
+  void seedFromHardware();
+  void seed(uint64_t value);
+
+  // Прыжок на 2^64 шагов вперёд: из одного засева - непересекающиеся
+  // последовательности (по прыжку на каждую следующую)
+  void jump();
+
+  uint32_t next();
+  uint32_t below(uint32_t range);
+  uint8_t  roll(uint8_t faces = 6);
+  void     fill(uint8_t* out, uint16_t count, uint8_t faces = 6);
+
+private:
+  void refill(uint8_t faces);
+
+  uint32_t state[4] = {0x9E3779B9u, 0x243F6A88u, 0xB7E15162u, 0x6A09E667u};
+
+  // Остаток текущей пачки: value - ещё не выданные цифры по основанию batchFaces
+  uint32_t batchValue = 0;
+  uint8_t  batchLeft  = 0;
+  uint8_t  batchFaces = 0;
+};
+
+// Засев из esp_random()
+void seedFromHardware();
+
+// Детерминированный засев: одинаковый seed - одинаковые броски
+void seed(uint64_t value);
+
+// Следующее сырое 32-битное число
+uint32_t next();
+
+// Равномерно в [0, range), range > 0
+uint32_t below(uint32_t range);
+
+// Бросок кубика с faces гранями (2..255): 1..faces
+uint8_t roll(uint8_t faces = 6);
+
+// count бросков подряд в out
+void fill(uint8_t* out, uint16_t count, uint8_t faces = 6);
+
+} // namespace DiceRng
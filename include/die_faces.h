@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <Adafruit_ST7735.h>
+
+#include "config.h"
+#include "pip_sprites.h"
+#include "render_target.h"
+#include "timer_glyphs.h"
+
+// ----------------------------------------------------------
+// Грани кубика для любой кости d2..d20.
+//
+// Способ выбирается при компиляции по Config::Dice::FACES: до
+// девяти граней - точки (PipSprites), больше - число из цифр
+// шрифта GFX, заранее увеличенных под размер кубика. Ветвления
+// "точки или цифры" в коде отрисовки нет: реализация выбирается
+// специализацией шаблона, неиспользуемая даже не собирается.
+// ----------------------------------------------------------
+
+namespace DieFaces {
+
+inline constexpr bool USE_PIPS = Config::Dice::FACES <= PipSprites::MAX_PIPS;
+
+// Масштаб цифр: два символа 6x8 по ширине кубика без скруглений
+inline constexpr uint8_t  NUMERAL_SCALE = (Config::Dice::SIZE - Config::Dice::RADIUS) / 12;
+inline constexpr uint16_t NUMERAL_CELL_W = 6 * NUMERAL_SCALE;
+inline constexpr uint16_t NUMERAL_CELL_H = 8 * NUMERAL_SCALE;
+
+// Окно числа: две ячейки; по центру кубика - видимая часть без
+// пустого столбца справа у второй ячейки
+inline constexpr uint16_t NUMERAL_W        = 2 * NUMERAL_CELL_W;
+inline constexpr uint16_t NUMERAL_H        = NUMERAL_CELL_H;
+inline constexpr int16_t  NUMERAL_OFFSET_X = (Config::Dice::SIZE - NUMERAL_W + NUMERAL_SCALE) / 2;
+inline constexpr int16_t  NUMERAL_OFFSET_Y = (Config::Dice::SIZE - NUMERAL_H) / 2;
+
+// Углы окна числа не должны заходить на скругление кубика (правый ближе к краю)
+inline constexpr int16_t NUMERAL_INSET_X =
+    static_cast<int16_t>(Config::Dice::RADIUS) - (Config::Dice::SIZE - NUMERAL_OFFSET_X - NUMERAL_W);
+inline constexpr int16_t NUMERAL_INSET_Y = static_cast<int16_t>(Config::Dice::RADIUS) - NUMERAL_OFFSET_Y;
+static_assert(USE_PIPS || (NUMERAL_SCALE >= 1 && Config::Dice::SIZE - NUMERAL_OFFSET_X - NUMERAL_W >= 1 &&
+              (NUMERAL_INSET_X <= 0 || NUMERAL_INSET_Y <= 0 ||
+               NUMERAL_INSET_X * NUMERAL_INSET_X + NUMERAL_INSET_Y * NUMERAL_INSET_Y <=
+                   Config::Dice::RADIUS * Config::Dice::RADIUS)),
+              "Число на грани не помещается в кубик");
+
+using DigitMask = PipSprites::Mask<NUMERAL_CELL_W, NUMERAL_CELL_H>;
+
+constexpr DigitMask buildDigit(uint8_t digit) {
+  DigitMask mask{};
+  for (uint16_t y = 0; y < NUMERAL_CELL_H; ++y) {
+    for (uint16_t x = 0; x < NUMERAL_CELL_W; ++x) {
+      const uint16_t column = x / NUMERAL_SCALE;
+      if (column < 5 && ((TimerGlyphs::FONT_DIGITS[digit][column] >> (y / NUMERAL_SCALE)) & 1)) {
+        mask.set(x, y);
+      }
+    }
+  }
+  return mask;
+}
+
+struct DigitSet {
+  DigitMask digits[10];
+};
+
+constexpr DigitSet buildDigits() {
+  DigitSet set{};
+  for (uint8_t d = 0; d < 10; ++d) {
+    set.digits[d] = buildDigit(d);
+  }
+  return set;
+}
+
+// Грань value целиком на только что залитом кубике (x, y); 0 - пустая
+void draw(RenderTarget& target, int16_t x, int16_t y, uint8_t value, uint16_t pipColor, uint16_t fillColor);
+
+// Смена грани oldValue -> value без перезаливки кубика
+void update(RenderTarget& target, int16_t x, int16_t y, uint8_t oldValue, uint8_t value,
+            uint16_t pipColor, uint16_t fillColor);
+
+} // namespace DieFaces
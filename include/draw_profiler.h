@@ -0,0 +1,135 @@
+#pragma once
+
+#include <stdint.h>
+
+// ----------------------------------------------------------
+// Учёт стоимости отрисовки (включается флагом сборки -DDRAW_PROFILER).
+//
+// Каждый байт, ушедший на шину дисплея, относится к текущему
+// обработчику (handleDiceAnimation, drawTimer, ...) и текущему
+// примитиву (fillRoundRect, текст, спрайт, отправка теневого кадра...).
+// Для примитива считаются вызовы, окна CASET/RASET, байты команд,
+// параметров и пикселей, а также время CPU в микросекундах
+// (для DMA-шины - время постановки в очередь, а не передачи).
+//
+// Отчёт печатается в Serial по команде 'p', сброс - 'r'.
+// Счётчики пополняет задача отрисовки, а отчёт читает loop()
+// без синхронизации: цифры могут отставать на кадр.
+// Без флага все макросы пустые и код профилировщика не собирается.
+// ----------------------------------------------------------
+
+#if defined(DRAW_PROFILER)
+
+#include <Arduino.h>
+
+#include "tft_bus.h"
+
+namespace DrawProfiler {
+
+enum class Handler : uint8_t {
+  Other, Intro, DiceRoll, DiceAnimation, Timer, Alert,
+  COUNT
+};
+
+enum class Primitive : uint8_t {
+  Other, FillScreen, FillRect, RoundRect, Triangle, Circle, Text, Sprite, Glyph, Command, Flush,
+  COUNT
+};
+
+struct Counters {
+  uint32_t calls;
+  uint32_t windows;
+  uint32_t commandBytes;
+  uint32_t paramBytes;
+  uint32_t pixelBytes;
+  uint32_t micros;
+};
+
+// Текущий обработчик на время жизни объекта
+class HandlerScope {
+public:
+  explicit HandlerScope(Handler handler);
+  ~HandlerScope();
+
+private:
+  Handler previous;
+};
+
+// Текущий примитив; вложенные примитивы (fillRect внутри
+// fillRoundRect) засчитываются внешнему
+class PrimitiveScope {
+public:
+  explicit PrimitiveScope(Primitive primitive);
+  ~PrimitiveScope();
+
+private:
+  bool     outermost;
+  uint32_t startUs;
+};
+
+// Отправка теневого кадра: байты относятся к обработчику,
+// который рисовал в этом проходе loop()
+class FrameScope {
+public:
+  FrameScope();
+
+private:
+  HandlerScope   handler;
+  PrimitiveScope primitive;
+};
+
+// Шина-обёртка: считает байты и передаёт их настоящей шине
+class ProfilingBus : public TftBus {
+public:
+  explicit ProfilingBus(TftBus& inner) : target(inner) {}
+
+  void begin() override;
+  void writeCommand(uint8_t cmd) override;
+  void writeData(const uint8_t* data, size_t len) override;
+  void writeColor(uint16_t color, uint32_t count) override;
+  void writePixels(const uint16_t* pixels, uint32_t count) override;
+  uint32_t queuePixels(const uint16_t* wirePixels, uint32_t count) override;
+  void waitQueued(uint32_t token) override;
+  void flush() override;
+
+private:
+  TftBus& target;
+};
+
+TftBus& wrapBus(TftBus& bus);
+void setState(uint8_t state);
+
+void reset();
+void report(Print& out, const char* const* stateNames, uint8_t stateCount);
+
+// Ячейка таблицы счётчиков (проверки стоимости кадров в тестах)
+const Counters& counters(Handler handler, Primitive primitive);
+
+// Команда из Serial: 'p' - отчёт, 'r' - сброс
+void command(char c, const char* const* stateNames, uint8_t stateCount);
+
+} // namespace DrawProfiler
+
+#define DRAW_PROFILE_CONCAT_(a, b) a##b
+#define DRAW_PROFILE_CONCAT(a, b)  DRAW_PROFILE_CONCAT_(a, b)
+
+#define DRAW_PROFILE_HANDLER(name) \
+  DrawProfiler::HandlerScope DRAW_PROFILE_CONCAT(drawProfileHandler, __LINE__)(DrawProfiler::Handler::name)
+#define DRAW_PROFILE_PRIMITIVE(name) \
+  DrawProfiler::PrimitiveScope DRAW_PROFILE_CONCAT(drawProfilePrimitive, __LINE__)(DrawProfiler::Primitive::name)
+#define DRAW_PROFILE_FRAME() \
+  DrawProfiler::FrameScope DRAW_PROFILE_CONCAT(drawProfileFrame, __LINE__)
+#define DRAW_PROFILE_STATE(state)            DrawProfiler::setState(static_cast<uint8_t>(state))
+#define DRAW_PROFILE_BUS(bus)                DrawProfiler::wrapBus(bus)
+#define DRAW_PROFILE_COMMAND(c, names, n)    DrawProfiler::command(c, names, n)
+
+#else
+
+#define DRAW_PROFILE_HANDLER(name)           do {} while (0)
+#define DRAW_PROFILE_PRIMITIVE(name)         do {} while (0)
+#define DRAW_PROFILE_FRAME()                 do {} while (0)
+#define DRAW_PROFILE_STATE(state)            do {} while (0)
+#define DRAW_PROFILE_BUS(bus)                (bus)
+#define DRAW_PROFILE_COMMAND(c, names, n)    ((void)(c))
+
+#endif // defined(DRAW_PROFILER)
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <Adafruit_ST7735.h>
+
+#include "config.h"
+#include "log_events.h"
+
+class Print;
+
+// ----------------------------------------------------------
+// Журнал событий вместо Serial.print в loop().
+//
+// EVENT_LOG(Имя, аргументы...) кладёт в кольцо RAM компактную
+// запись: номер события, время в мкс и до MAX_ARGS целых. Это
+// несколько сохранений в память - loop() никогда не ждёт UART.
+// В Serial записи выводит задача с низким приоритетом, в
+// двоичном виде; в текст их превращает декодер на хосте
+// (program --decode-log FILE). События ниже Config::Log::LEVEL
+// не компилируются: не остаётся ни вызова, ни вычисления
+// аргументов. Писатель один - loop().
+//
+// Запись на линии: SYNC, событие, число аргументов, время (4 байта),
+// аргументы (по 4 байта, младший байт первым), контрольный байт.
+// Текст, который по-прежнему печатается напрямую (setup(), отчёты),
+// - ASCII, поэтому SYNC >= 0x80 не спутать с ним.
+// ----------------------------------------------------------
+
+namespace EventLog {
+
+using Level = Config::Log::Level;
+
+enum class Event : uint8_t {
+#define EVENT_LOG_ENUM(name, level, format) name,
+  EVENT_LOG_EVENTS(EVENT_LOG_ENUM)
+#undef EVENT_LOG_ENUM
+  COUNT
+};
+
+inline constexpr uint8_t EVENT_COUNT = static_cast<uint8_t>(Event::COUNT);
+
+inline constexpr Level LEVELS[EVENT_COUNT] = {
+#define EVENT_LOG_LEVEL(name, level, format) Level::level,
+  EVENT_LOG_EVENTS(EVENT_LOG_LEVEL)
+#undef EVENT_LOG_LEVEL
+};
+
+inline constexpr const char* FORMATS[EVENT_COUNT] = {
+#define EVENT_LOG_FORMAT(name, level, format) format,
+  EVENT_LOG_EVENTS(EVENT_LOG_FORMAT)
+#undef EVENT_LOG_FORMAT
+};
+
+inline constexpr uint8_t MAX_ARGS = 4;
+
+// Число аргументов по формату (каждый % - один аргумент)
+constexpr uint8_t argCount(Event event) {
+  uint8_t count = 0;
+  for (const char* c = FORMATS[static_cast<uint8_t>(event)]; *c != '\0'; ++c) {
+    count += (*c == '%');
+  }
+  return count;
+}
+
+constexpr bool enabled(Event event) {
+  return Config::Log::LEVEL != Level::Off && LEVELS[static_cast<uint8_t>(event)] >= Config::Log::LEVEL;
+}
+
+struct Record {
+  uint32_t timeUs;   // esp_timer, переполняется раз в 71 минуту
+  Event    event;
+  uint8_t  argc;
+  int32_t  args[MAX_ARGS];
+};
+
+// Формат на линии
+inline constexpr uint8_t SYNC         = 0xA5;
+inline constexpr size_t  HEADER_BYTES = 7;   // SYNC, событие, argc, время
+inline constexpr size_t  MAX_WIRE_BYTES = HEADER_BYTES + 4 * MAX_ARGS + 1;
+
+// Упаковать запись для линии; возвращает число байт
+size_t encode(const Record& record, uint8_t* out);
+
+// Запустить задачу вывода
+void begin();
+
+// Положить запись в кольцо (только loop(); напрямую не вызывается - см. EVENT_LOG)
+void write(Event event, const int32_t* args, uint8_t argc);
+
+template <Event E, typename... Args>
+inline void log(Args... args) {
+  static_assert(sizeof...(Args) == argCount(E), "Число аргументов не совпадает с форматом события");
+  static_assert(sizeof...(Args) <= MAX_ARGS, "Слишком много аргументов события");
+  const int32_t values[sizeof...(Args) + 1] = {static_cast<int32_t>(args)..., 0};
+  write(E, values, sizeof...(Args));
+}
+
+// Дождаться вывода всего кольца (перед ESP.restart())
+void flush();
+
+// Отброшено записей из-за переполнения кольца
+uint32_t droppedCount();
+
+#if !defined(ESP32)
+// Хост: поток байт с линии -> текст. Байты вне записей (ASCII)
+// проходят как есть, запись становится строкой "[время] текст".
+class Decoder {
+public:
+  void feed(uint8_t byte, Print& out);
+
+  uint32_t records = 0;
+  uint32_t corrupt = 0;
+
+private:
+  uint8_t frame[MAX_WIRE_BYTES];
+  size_t  filled   = 0;
+  size_t  expected = 0;
+};
+
+// Запись текстом по формату события
+void format(const Record& record, Print& out);
+#endif
+
+} // namespace EventLog
+
+#define EVENT_LOG(name, ...)                                        \
+  do {                                                              \
+    if constexpr (EventLog::enabled(EventLog::Event::name)) {       \
+      EventLog::log<EventLog::Event::name>(__VA_ARGS__);            \
+    }                                                               \
+  } while (0)
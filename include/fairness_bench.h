@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+
+// ----------------------------------------------------------
+// Проверка честности бросков (только хост: program --fairness N).
+//
+// N бросков набора Config::Dice (COUNT кубиков по FACES граней)
+// делятся между потоками; у каждого потока свой DiceRng::Generator
+// из общего засева, разведённый прыжками на 2^64 шагов, и свои
+// гистограммы - общего состояния нет до слияния в конце. Засев тот
+// же, что в setup() (seedFromHardware), или --seed для повтора.
+//
+// По слитым гистограммам: хи-квадрат граней, сумм (против точного
+// распределения, для 2d6 - k/36), пар соседних бросков и цветов
+// суммы getColorForSum(), сериальная корреляция сумм, проверка
+// самой шкалы цветов (симметрия вокруг среднего, монотонность) и
+// скорость в бросках в секунду - для сравнения изменений в RNG.
+// Код возврата не ноль, если хоть одна проверка не прошла.
+// ----------------------------------------------------------
+
+#if !defined(ESP32)
+
+namespace FairnessBench {
+
+// threads == 0 - по числу ядер; seeded == false - засев как в setup()
+int run(uint64_t rolls, unsigned threads, bool seeded, uint64_t seed);
+
+} // namespace FairnessBench
+
+#endif // !defined(ESP32)
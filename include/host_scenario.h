@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+
+// ----------------------------------------------------------
+// Сценарий хост-прогона: события на виртуальной шкале времени
+// (фронты кнопки, снимки экрана, ввод Serial) и прогон
+// setup()/loop() между ними. Общий для программы [env:native]
+// (host_main.cpp) и тестов с эталонными кадрами (test/).
+//
+// setup() и loop() держат состояние в глобальных переменных,
+// поэтому на процесс - один прогон: begin() один раз, затем
+// runUntil() с растущими моментами.
+// ----------------------------------------------------------
+
+#if !defined(ESP32)
+
+namespace HostScenario {
+
+// Короткое нажатие кнопки в момент atMs (мс виртуального времени)
+void press(unsigned long atMs, unsigned long durationMs);
+
+// Нажатие с дребезгом: несколько переключений через 1 мс на обоих фронтах
+void bouncyPress(unsigned long atMs, unsigned long durationMs);
+
+// Отдельный фронт: уровень level на входе кнопки
+void edge(unsigned long atMs, uint8_t level);
+
+// Снимок экрана в PPM в момент atMs
+void frame(unsigned long atMs, const char* path);
+
+// Подать text в Serial в момент atMs
+void serial(unsigned long atMs, const char* text);
+
+// Есть ли в сценарии нажатия кнопки
+bool hasButton();
+
+// setup(); renderThreaded - команды отрисовки в отдельном потоке
+// (Renderer::setHostThreaded() должен быть включён до этого)
+void begin(bool renderThreaded);
+
+// loop() до момента endMs или до ESP.restart(); события сценария
+// выполняются в свои моменты. Возвращает число проходов loop()
+uint32_t runUntil(unsigned long endMs);
+
+} // namespace HostScenario
+
+#endif // !defined(ESP32)
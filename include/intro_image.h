@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <Adafruit_ST7735.h>
+
+#include "config.h"
+#include "render_target.h"
+
+// ----------------------------------------------------------
+// Интро-экран, собранный на этапе компиляции.
+//
+// Надписи "DICE ROLLER" и подсказка растеризуются встроенным
+// шрифтом GFX с теми же позициями, размерами и цветами, что
+// заданы в Config::Intro и Config::Colors, - попиксельно как
+// println() - и сжимаются RLE. Картинка лежит во flash и
+// выводится одним окном на весь экран: строка распаковывается
+// в буфер и сразу уходит на шину, вместо сотен fillRect от
+// увеличенного текста.
+// ----------------------------------------------------------
+
+namespace IntroImage {
+
+inline constexpr uint16_t WIDTH  = Config::Display::WIDTH;
+inline constexpr uint16_t HEIGHT = Config::Display::HEIGHT;
+
+// Объём сжатой картинки во flash, байт
+uint32_t compressedBytes();
+
+// Весь экран одним окном
+void draw(RenderTarget& target);
+
+} // namespace IntroImage
@@ -0,0 +1,34 @@
+#pragma once
+
+// ----------------------------------------------------------
+// Таблица событий журнала: имя, уровень, формат текста.
+//
+// На устройстве в запись попадают только номер события, время и
+// целые аргументы; формат нужен лишь декодеру на хосте. Формат -
+// подмножество printf: %d, %u и %G (имя жеста кнопки). Новые
+// события добавляются в конец, чтобы старые записи декодировались.
+// ----------------------------------------------------------
+
+#define EVENT_LOG_EVENTS(X) \
+  X(LogDropped,        Warn,  "Log: %u records dropped (ring full)") \
+  X(DieValue,          Info,  "Dice %u: %u") \
+  X(RollAnimation,     Info,  "Roll animation: %u frames; since boot merged %u, skipped %u, max late %u us") \
+  X(RollFrameDraw,     Debug, "Frame draw last/max %u/%u us") \
+  X(ResultShown,       Info,  "Showing result for %u seconds, then timer will start automatically.") \
+  X(ResultTimeout,     Info,  "Result shown, starting timer automatically...") \
+  X(TimerStarted,      Info,  "Timer started (%u s). Next press will roll dice.") \
+  X(TimerTick,         Debug, "Timer: %d") \
+  X(TimerDrift,        Info,  "Timer drift: %d us, handled %d us after deadline") \
+  X(AlertStarted,      Info,  "Timer finished. Alert mode activated.") \
+  X(HistorySaved,      Info,  "History saved: %u rolls, NVS writes %u") \
+  X(ButtonGesture,     Info,  "Button %G, latency %u us") \
+  X(LongPress,         Warn,  "Long press detected. Rebooting...") \
+  X(ManualRoll,        Info,  "Manual roll (button pressed)!") \
+  X(LegacyTimer,       Info,  "Starting timer (legacy path)...") \
+  X(DoubleClickTimer,  Info,  "Double click: starting timer now...") \
+  X(ResultBusy,        Info,  "Please wait, result is being displayed...") \
+  X(TimerInterrupted,  Info,  "Timer interrupted. Rolling dice...") \
+  X(AlertAcknowledged, Info,  "Alert acknowledged. Rolling dice...") \
+  X(MelodySkipped,     Info,  "Melody already played, skipping...") \
+  X(MelodyStarted,     Info,  "Starting intro melody (one-time play)") \
+  X(PipOperations,     Info, "Pip operations during roll: %u")
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "scheduler.h"
+
+class Print;
+
+// ----------------------------------------------------------
+// Трасса loop() (включается флагом сборки -DLOOP_TRACE).
+//
+// Каждый проход loop(), каждая задача планировщика (кадр
+// анимации, секунда таймера, мигание алерта...) и обработка
+// жеста кнопки отмечают начало и конец по esp_timer. Опоздание -
+// насколько начало позже цели: срока задачи, запланированного
+// пробуждения loop(), фронта кнопки. По каждой дорожке ведутся
+// гистограмма опозданий, максимум длительности и число промахов -
+// опозданий больше допуска из Config::Trace. Последние отрезки
+// лежат в кольце фиксированного размера.
+//
+// По 't' в Serial уходят сводка и отрезки текстом, 'r' - сброс.
+// На хосте program --trace-json FILE превращает снятый вывод в
+// JSON trace_event для chrome://tracing или Perfetto.
+// Пишет и читает только loop(), синхронизации нет.
+// Без флага все макросы пустые и код трассы не собирается.
+// ----------------------------------------------------------
+
+namespace LoopTrace {
+
+// Дорожки: проход loop(), жест кнопки, затем задачи в порядке Scheduler::Job
+enum class Track : uint8_t {
+  Pass, Button,
+  AnimationFrame, ResultTimeout, TimerSecond, AlertBlink, ButtonCheck, HistoryFlush,
+  COUNT
+};
+
+constexpr Track jobTrack(Scheduler::Job job) {
+  return static_cast<Track>(static_cast<uint8_t>(Track::AnimationFrame) + static_cast<uint8_t>(job));
+}
+
+static_assert(static_cast<uint8_t>(Track::COUNT) ==
+                static_cast<uint8_t>(Track::AnimationFrame) + static_cast<uint8_t>(Scheduler::Job::COUNT),
+              "Дорожки задач должны повторять Scheduler::Job");
+
+#if !defined(ESP32)
+// Хост: снятый вывод 't' -> JSON trace_event; false - отрезков не нашлось
+bool writeChromeJson(const char* path, Print& out);
+#endif
+
+} // namespace LoopTrace
+
+#if defined(LOOP_TRACE)
+
+namespace LoopTrace {
+
+// Отрезок дорожки на время жизни объекта; targetUs - когда он должен был начаться
+class Scope {
+public:
+  Scope(Track track, uint64_t targetUs);
+  ~Scope();
+
+private:
+  Track    track;
+  uint64_t startUs;
+  uint64_t targetUs;
+};
+
+// Проход loop(): от пробуждения до следующего сна
+void passBegin();
+void passEnd();
+
+// Срок, до которого loop() собирается спать (Scheduler::waitForNext)
+void plannedWake(uint64_t wakeAtUs);
+
+void reset();
+void report(Print& out);
+
+// Команда из Serial: 't' - сводка и отрезки, 'r' - сброс
+void command(char c);
+
+} // namespace LoopTrace
+
+#define LOOP_TRACE_CONCAT_(a, b) a##b
+#define LOOP_TRACE_CONCAT(a, b)  LOOP_TRACE_CONCAT_(a, b)
+
+#define LOOP_TRACE_JOB(job, deadlineUs) \
+  LoopTrace::Scope LOOP_TRACE_CONCAT(loopTraceJob, __LINE__)(LoopTrace::jobTrack(job), deadlineUs)
+#define LOOP_TRACE_BUTTON(edgeUs) \
+  LoopTrace::Scope LOOP_TRACE_CONCAT(loopTraceButton, __LINE__)(LoopTrace::Track::Button, edgeUs)
+#define LOOP_TRACE_PASS_BEGIN()        LoopTrace::passBegin()
+#define LOOP_TRACE_PASS_END()          LoopTrace::passEnd()
+#define LOOP_TRACE_WAKE(wakeAtUs)      LoopTrace::plannedWake(wakeAtUs)
+#define LOOP_TRACE_COMMAND(c)          LoopTrace::command(c)
+
+#else
+
+#define LOOP_TRACE_JOB(job, deadlineUs) do {} while (0)
+#define LOOP_TRACE_BUTTON(edgeUs)       do {} while (0)
+#define LOOP_TRACE_PASS_BEGIN()         do {} while (0)
+#define LOOP_TRACE_PASS_END()           do {} while (0)
+#define LOOP_TRACE_WAKE(wakeAtUs)       do {} while (0)
+#define LOOP_TRACE_COMMAND(c)           ((void)(c))
+
+#endif // defined(LOOP_TRACE)
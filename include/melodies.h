@@ -0,0 +1,172 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <Adafruit_ST7735.h>
+#include "config.h"
+
+// ----------------------------------------------------------
+// Библиотека мелодий во flash.
+//
+// Нота - одно 16-битное слово: 7 бит высоты (номер MIDI, 0 -
+// пауза) и 9 бит длительности в тиках по TICK_MS. Исходник
+// мелодии пишется в миллисекундах и полутонах, а темп и
+// транспонирование применяются при компиляции (compile()), так
+// что на проигрывании - только сдвиги и поиск частоты в таблице,
+// без float. Все мелодии регистрируются в одной таблице LIBRARY,
+// число нот выводится из размера массива.
+// ----------------------------------------------------------
+
+namespace Melodies {
+
+inline constexpr uint16_t TICK_MS    = 5;
+inline constexpr uint8_t  PITCH_BITS = 7;
+inline constexpr uint8_t  TICK_BITS  = 16 - PITCH_BITS;
+inline constexpr uint16_t MAX_TICKS  = (1u << TICK_BITS) - 1; // 2555 мс
+inline constexpr uint8_t  MAX_PITCH  = (1u << PITCH_BITS) - 1;
+inline constexpr uint8_t  REST       = 0;
+
+// Полутоны внутри октавы
+namespace Note {
+  inline constexpr uint8_t C = 0, Cs = 1, Db = 1, D = 2, Ds = 3, Eb = 3, E = 4, F = 5,
+                           Fs = 6, Gb = 6, G = 7, Gs = 8, Ab = 8, A = 9, As = 10, Bb = 10, B = 11;
+}
+
+// Номер MIDI ноты: pitch(Note::A, 4) == 69 (440 Гц)
+constexpr uint8_t pitch(uint8_t semitone, uint8_t octave) {
+  return static_cast<uint8_t>((octave + 1) * 12 + semitone);
+}
+
+// Нота исходника: высота и длительность в мс до масштабирования темпа
+struct Source {
+  uint8_t  pitch;
+  uint16_t ms;
+};
+
+constexpr uint16_t pack(uint8_t notePitch, uint16_t ticks) {
+  return static_cast<uint16_t>((notePitch << TICK_BITS) | ticks);
+}
+
+constexpr uint8_t pitchOf(uint16_t packed) {
+  return static_cast<uint8_t>(packed >> TICK_BITS);
+}
+
+constexpr uint16_t ticksOf(uint16_t packed) {
+  return packed & MAX_TICKS;
+}
+
+// ----------------------------------------------------------
+// Преобразования при компиляции
+// ----------------------------------------------------------
+
+template <size_t N>
+struct Packed {
+  uint16_t notes[N];
+};
+
+// Темп в процентах (150 - в полтора раза медленнее), сдвиг в полутонах.
+// Длительности округляются до ближайшего тика
+constexpr uint16_t scaledTicks(uint16_t ms, uint16_t tempoPercent) {
+  const uint32_t scaledMs = (static_cast<uint32_t>(ms) * tempoPercent + 50) / 100;
+  return static_cast<uint16_t>((scaledMs + TICK_MS / 2) / TICK_MS);
+}
+
+template <size_t N>
+constexpr Packed<N> compile(const Source (&source)[N], uint16_t tempoPercent, int8_t transpose) {
+  Packed<N> out{};
+  for (size_t i = 0; i < N; i++) {
+    const uint8_t p = source[i].pitch == REST ? REST : static_cast<uint8_t>(source[i].pitch + transpose);
+    out.notes[i] = pack(p, scaledTicks(source[i].ms, tempoPercent));
+  }
+  return out;
+}
+
+// Влезает ли исходник в формат после темпа и транспонирования
+template <size_t N>
+constexpr bool fits(const Source (&source)[N], uint16_t tempoPercent, int8_t transpose) {
+  for (size_t i = 0; i < N; i++) {
+    if (source[i].pitch != REST) {
+      const int p = source[i].pitch + transpose;
+      if (p <= REST || p > MAX_PITCH) {
+        return false;
+      }
+    }
+    if (scaledTicks(source[i].ms, tempoPercent) > MAX_TICKS) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ----------------------------------------------------------
+// Частоты равномерно темперированного строя, A4 = 440 Гц
+// ----------------------------------------------------------
+
+struct FrequencyTable {
+  uint16_t hz[MAX_PITCH + 1];
+};
+
+constexpr FrequencyTable makeFrequencyTable() {
+  constexpr double SEMITONE = 1.0594630943592953; // 2^(1/12)
+  FrequencyTable table{};
+  double f = 440.0;
+  for (int p = 69; p <= MAX_PITCH; p++, f *= SEMITONE) {
+    table.hz[p] = static_cast<uint16_t>(f + 0.5);
+  }
+  f = 440.0 / SEMITONE;
+  for (int p = 68; p > REST; p--, f /= SEMITONE) {
+    table.hz[p] = static_cast<uint16_t>(f + 0.5);
+  }
+  table.hz[REST] = 0;
+  return table;
+}
+
+inline constexpr FrequencyTable FREQUENCIES = makeFrequencyTable();
+
+static_assert(FREQUENCIES.hz[pitch(Note::A, 4)] == 440, "A4 = 440 Гц");
+
+constexpr uint16_t frequencyOf(uint16_t packed) {
+  return FREQUENCIES.hz[pitchOf(packed)];
+}
+
+constexpr uint16_t durationMsOf(uint16_t packed) {
+  return static_cast<uint16_t>(ticksOf(packed) * TICK_MS);
+}
+
+// ----------------------------------------------------------
+// Исходники мелодий
+// ----------------------------------------------------------
+
+namespace Sources {
+#include "rock_1.h"
+}
+
+// ----------------------------------------------------------
+// Единая таблица мелодий
+// ----------------------------------------------------------
+
+struct Melody {
+  const char*     name;
+  const uint16_t* notes;
+  uint16_t        count;
+};
+
+template <size_t N>
+constexpr Melody entry(const char* name, const Packed<N>& packed) {
+  return {name, packed.notes, static_cast<uint16_t>(N)};
+}
+
+inline constexpr uint16_t TEMPO     = Config::Sound::TEMPO_PERCENT;
+inline constexpr int8_t   TRANSPOSE = Config::Sound::TRANSPOSE_SEMITONES;
+
+inline constexpr auto OMNI_STYLE_LOOP = compile(Sources::OMNI_STYLE_LOOP, TEMPO, TRANSPOSE);
+static_assert(fits(Sources::OMNI_STYLE_LOOP, TEMPO, TRANSPOSE), "OMNI_STYLE_LOOP не влезает в формат");
+
+inline constexpr Melody LIBRARY[] = {
+  entry("omni-style loop", OMNI_STYLE_LOOP),
+};
+
+inline constexpr uint8_t COUNT = sizeof(LIBRARY) / sizeof(LIBRARY[0]);
+
+} // namespace Melodies
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#include "tft_bus.h"
+
+// ----------------------------------------------------------
+// Шина-заглушка для хоста: записывает поток байт в том виде,
+// в каком он ушёл бы на провод (команды с DC = 0, данные с DC = 1,
+// цвета в big-endian). Позволяет сравнивать вывод драйвера
+// с эталонным потоком Adafruit_ST7735 байт в байт.
+//
+// Заодно эмулирует панель: разбирает CASET/RASET/RAMWR и
+// складывает пиксели в кадр в памяти, так что на хосте можно
+// снять "снимок экрана" (savePpm) и сравнить его с эталоном.
+// Аппаратная прокрутка (VSCRDEF/VSCRSADD/NORON) учитывается в
+// снимке с учётом MY/MV из MADCTL, как у панели 128x160.
+// ----------------------------------------------------------
+
+class MockTftBus : public TftBus {
+public:
+  // Размер памяти кадра контроллера ST7735 (132x162)
+  static constexpr uint16_t PANEL_WIDTH  = 162;
+  static constexpr uint16_t PANEL_HEIGHT = 162;
+
+  // Строк развёртки у панели 128x160 (ось аппаратной прокрутки)
+  static constexpr uint16_t SCAN_LINES = 160;
+
+  struct Byte {
+    bool    command;
+    uint8_t value;
+
+    bool operator==(const Byte& other) const {
+      return command == other.command && value == other.value;
+    }
+  };
+
+  MockTftBus() : panel(PANEL_WIDTH * PANEL_HEIGHT, 0) {}
+
+  void begin() override {
+    ++resetCount;
+    displayOn = false;
+    inverted  = false;
+    scrolling = false;
+  }
+
+  void writeCommand(uint8_t cmd) override {
+    record(true, cmd);
+    ++commandBytes;
+    command    = cmd;
+    paramIndex = 0;
+
+    switch (cmd) {
+      case 0x2C: // RAMWR
+        cursorX = windowX0;
+        cursorY = windowY0;
+        break;
+      case 0x20: // INVOFF
+        inverted = false;
+        break;
+      case 0x21: // INVON
+        inverted = true;
+        break;
+      case 0x28: // DISPOFF
+        displayOn = false;
+        break;
+      case 0x29: // DISPON
+        displayOn = true;
+        break;
+      case 0x13: // NORON: выход из прокрутки
+        scrolling = false;
+        break;
+    }
+  }
+
+  void writeData(const uint8_t* data, size_t len) override {
+    for (size_t i = 0; i < len; ++i) {
+      record(false, data[i]);
+      ++dataBytes;
+      parameter(data[i]);
+    }
+  }
+
+  void writeColor(uint16_t color, uint32_t count) override {
+    while (count--) {
+      pushPixel(color);
+    }
+  }
+
+  void writePixels(const uint16_t* pixels, uint32_t count) override {
+    for (uint32_t i = 0; i < count; ++i) {
+      pushPixel(pixels[i]);
+    }
+  }
+
+  void clear() {
+    bytes.clear();
+    commandBytes = 0;
+    dataBytes    = 0;
+  }
+
+  // Количество байт команд (удобно для проверок "сколько стоит кадр")
+  size_t commandCount() const {
+    return commandBytes;
+  }
+
+  // Пиксель памяти кадра по адресу столбец/строка (как их задают CASET/RASET)
+  uint16_t pixel(uint16_t x, uint16_t y) const {
+    return (x < PANEL_WIDTH && y < PANEL_HEIGHT) ? panel[y * PANEL_WIDTH + x] : 0;
+  }
+
+  // Пиксель, видимый в точке экрана (x, y): строка развёртки вдоль оси
+  // прокрутки (x при MV, иначе y) подменяется строкой памяти из VSCRSADD
+  uint16_t visible(uint16_t x, uint16_t y) const {
+    if (!scrolling || scrollLines == 0) {
+      return pixel(x, y);
+    }
+    const bool mirrored = (madctl & 0x80) != 0; // MY
+    uint16_t&  along    = (madctl & 0x20) ? x : y; // MV
+    if (along >= SCAN_LINES) {
+      return pixel(x, y);
+    }
+    const uint16_t line = mirrored ? SCAN_LINES - 1 - along : along;
+    if (line >= scrollTop && line < scrollTop + scrollLines) {
+      const uint16_t shift  = static_cast<uint16_t>((scrollStart + scrollLines - scrollTop % scrollLines) % scrollLines);
+      const uint16_t memory = static_cast<uint16_t>(scrollTop + (line - scrollTop + shift) % scrollLines);
+      along = mirrored ? SCAN_LINES - 1 - memory : memory;
+    }
+    return pixel(x, y);
+  }
+
+  // Видимая область w x h в RGB888 построчно - то, что на экране
+  std::vector<uint8_t> rgb(uint16_t w, uint16_t h) const {
+    std::vector<uint8_t> out;
+    out.reserve(static_cast<size_t>(w) * h * 3);
+    for (uint16_t y = 0; y < h; ++y) {
+      for (uint16_t x = 0; x < w; ++x) {
+        uint16_t color = displayOn ? visible(x, y) : 0xFFFF;
+        if (inverted) {
+          color = static_cast<uint16_t>(~color);
+        }
+        out.push_back(static_cast<uint8_t>(((color >> 11) & 0x1F) * 255 / 31));
+        out.push_back(static_cast<uint8_t>(((color >> 5) & 0x3F) * 255 / 63));
+        out.push_back(static_cast<uint8_t>((color & 0x1F) * 255 / 31));
+      }
+    }
+    return out;
+  }
+
+  // Снимок области w x h в формате PPM (P6)
+  bool savePpm(const char* path, uint16_t w, uint16_t h) const {
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) {
+      return false;
+    }
+    const std::vector<uint8_t> pixels = rgb(w, h);
+    fprintf(file, "P6\n%u %u\n255\n", w, h);
+    fwrite(pixels.data(), 1, pixels.size(), file);
+    fclose(file);
+    return true;
+  }
+
+  // Поток байт сохраняется только при recording = true (тесты драйвера);
+  // счётчики и эмуляция панели работают всегда
+  bool recording = true;
+  std::vector<Byte> bytes;
+  uint32_t resetCount   = 0;
+  uint64_t commandBytes = 0;
+  uint64_t dataBytes    = 0;
+
+  // Состояние панели
+  bool displayOn = false;
+  bool inverted  = false;
+  bool scrolling = false;
+  uint8_t  madctl      = 0;
+  uint16_t scrollTop   = 0; // VSCRDEF: неподвижные строки сверху
+  uint16_t scrollLines = 0; //          строки области прокрутки
+  uint16_t scrollStart = 0; // VSCRSADD
+
+private:
+  void record(bool isCommand, uint8_t value) {
+    if (recording) {
+      bytes.push_back({isCommand, value});
+    }
+  }
+
+  void parameter(uint8_t value) {
+    const uint8_t index = paramIndex++;
+    switch (command) {
+      case 0x2A: // CASET: x0 (2 байта), x1 (2 байта)
+        setWindowByte(windowX0, windowX1, index, value);
+        break;
+      case 0x2B: // RASET
+        setWindowByte(windowY0, windowY1, index, value);
+        break;
+      case 0x36: // MADCTL
+        madctl = value;
+        break;
+      case 0x33: // VSCRDEF: TFA, VSA, BFA по 2 байта
+        if (index < 2) {
+          setWindowByte(scrollTop, scrollTop, index, value);
+        } else if (index < 4) {
+          setWindowByte(scrollLines, scrollLines, index - 2, value);
+        }
+        break;
+      case 0x37: // VSCRSADD: с ним панель переходит в режим прокрутки
+        setWindowByte(scrollStart, scrollStart, index, value);
+        scrolling = true;
+        break;
+      case 0x2C: // RAMWR: пиксели приходят парами байт
+        if (index & 1) {
+          storePixel(static_cast<uint16_t>((pendingHigh << 8) | value));
+        } else {
+          pendingHigh = value;
+        }
+        break;
+    }
+  }
+
+  static void setWindowByte(uint16_t& start, uint16_t& end, uint8_t index, uint8_t value) {
+    switch (index) {
+      case 0: start = static_cast<uint16_t>((start & 0x00FF) | (value << 8)); break;
+      case 1: start = static_cast<uint16_t>((start & 0xFF00) | value);        break;
+      case 2: end   = static_cast<uint16_t>((end & 0x00FF) | (value << 8));   break;
+      case 3: end   = static_cast<uint16_t>((end & 0xFF00) | value);          break;
+    }
+  }
+
+  void pushPixel(uint16_t color) {
+    record(false, static_cast<uint8_t>(color >> 8));
+    record(false, static_cast<uint8_t>(color & 0xFF));
+    dataBytes += 2;
+    if (command == 0x2C) {
+      storePixel(color);
+    }
+  }
+
+  // Запись в окно с переходом на следующую строку, как у контроллера
+  void storePixel(uint16_t color) {
+    if (cursorX < PANEL_WIDTH && cursorY < PANEL_HEIGHT) {
+      panel[cursorY * PANEL_WIDTH + cursorX] = color;
+    }
+    if (++cursorX > windowX1) {
+      cursorX = windowX0;
+      if (++cursorY > windowY1) {
+        cursorY = windowY0;
+      }
+    }
+  }
+
+  std::vector<uint16_t> panel;
+  uint8_t  command     = 0;
+  uint8_t  paramIndex  = 0;
+  uint8_t  pendingHigh = 0;
+  uint16_t windowX0 = 0;
+  uint16_t windowX1 = PANEL_WIDTH - 1;
+  uint16_t windowY0 = 0;
+  uint16_t windowY1 = PANEL_HEIGHT - 1;
+  uint16_t cursorX  = 0;
+  uint16_t cursorY  = 0;
+};
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <Adafruit_ST7735.h>
+
+#include "config.h"
+#include "render_target.h"
+
+// ----------------------------------------------------------
+// Спрайты точек кубика, собранные на этапе компиляции.
+// Сетка 3x3 позволяет нарисовать точками грани до девяти.
+// Маска точки растеризуется тем же алгоритмом, что и
+// Adafruit_GFX::fillCircle, поэтому результат совпадает
+// попиксельно, но выводится одним окном и одной пачкой
+// пикселей вместо десятков вертикальных линий.
+// ----------------------------------------------------------
+
+namespace PipSprites {
+
+inline constexpr int16_t  DOT_RADIUS = Config::Dice::DOT_RADIUS;
+inline constexpr uint16_t PIP_SIZE   = 2 * DOT_RADIUS + 1;
+
+// Координаты точек внутри кубика (как в исходном drawDice)
+inline constexpr int16_t PIP_LEFT   = Config::Dice::SIZE / 4;
+inline constexpr int16_t PIP_CENTER = Config::Dice::SIZE / 2;
+inline constexpr int16_t PIP_RIGHT  = (Config::Dice::SIZE * 3) / 4;
+
+// Область грани: квадрат, охватывающий все точки
+inline constexpr int16_t  FACE_OFFSET = PIP_LEFT - DOT_RADIUS;
+inline constexpr uint16_t FACE_SIZE   = PIP_RIGHT + DOT_RADIUS - FACE_OFFSET + 1;
+
+static_assert(PIP_CENTER - PIP_LEFT > 2 * DOT_RADIUS && PIP_RIGHT - PIP_CENTER > 2 * DOT_RADIUS,
+              "Точки кубика не должны перекрываться: уменьшите DOT_RADIUS");
+// Квадрат грани не должен задевать рамку и скруглённые углы кубика
+inline constexpr int16_t CORNER_INSET = static_cast<int16_t>(Config::Dice::RADIUS) - FACE_OFFSET;
+static_assert(FACE_OFFSET >= 1 &&
+              (CORNER_INSET <= 0 || 2 * CORNER_INSET * CORNER_INSET <= Config::Dice::RADIUS * Config::Dice::RADIUS),
+              "Область точек заходит на скругление углов кубика");
+
+// Позиции точек на сетке 3x3: 0 - левый край / верх, 1 - центр, 2 - правый край / низ
+enum Position : uint8_t {
+  TOP_LEFT, TOP_CENTER, TOP_RIGHT,
+  MIDDLE_LEFT, CENTER, MIDDLE_RIGHT,
+  BOTTOM_LEFT, BOTTOM_CENTER, BOTTOM_RIGHT,
+  POSITION_COUNT
+};
+
+inline constexpr int16_t POSITION_X[POSITION_COUNT] = {
+  PIP_LEFT, PIP_CENTER, PIP_RIGHT, PIP_LEFT, PIP_CENTER, PIP_RIGHT, PIP_LEFT, PIP_CENTER, PIP_RIGHT
+};
+inline constexpr int16_t POSITION_Y[POSITION_COUNT] = {
+  PIP_LEFT, PIP_LEFT, PIP_LEFT, PIP_CENTER, PIP_CENTER, PIP_CENTER, PIP_RIGHT, PIP_RIGHT, PIP_RIGHT
+};
+
+// Грань как 9-битная маска занятых позиций (бит i - позиция i)
+constexpr uint16_t bit(Position p) {
+  return static_cast<uint16_t>(1u << p);
+}
+
+// Больше 9 точек на грани не разместить - дальше грани рисуются цифрами
+inline constexpr uint8_t MAX_PIPS = 9;
+
+inline constexpr uint16_t CORNERS = bit(TOP_LEFT) | bit(TOP_RIGHT) | bit(BOTTOM_LEFT) | bit(BOTTOM_RIGHT);
+inline constexpr uint16_t SIDES   = bit(MIDDLE_LEFT) | bit(MIDDLE_RIGHT);
+
+inline constexpr uint16_t FACE_MASKS[MAX_PIPS + 1] = {
+  0,
+  bit(CENTER),
+  bit(TOP_LEFT) | bit(BOTTOM_RIGHT),
+  bit(TOP_LEFT) | bit(CENTER) | bit(BOTTOM_RIGHT),
+  CORNERS,
+  CORNERS | bit(CENTER),
+  CORNERS | SIDES,
+  CORNERS | SIDES | bit(CENTER),
+  CORNERS | SIDES | bit(TOP_CENTER) | bit(BOTTOM_CENTER),
+  CORNERS | SIDES | bit(TOP_CENTER) | bit(BOTTOM_CENTER) | bit(CENTER),
+};
+
+constexpr uint16_t faceMask(int value) {
+  return (value >= 0 && value <= MAX_PIPS) ? FACE_MASKS[value] : 0;
+}
+
+// Спрайты граней собираются только для костей, которые рисуются точками
+inline constexpr uint8_t FACE_COUNT = Config::Dice::FACES <= MAX_PIPS ? Config::Dice::FACES + 1 : 1;
+
+// ----------------------------------------------------------
+// 1-битные маски (строки по байтам, старший бит - левый пиксель)
+// ----------------------------------------------------------
+
+template <uint16_t W, uint16_t H>
+struct Mask {
+  static constexpr uint16_t WIDTH     = W;
+  static constexpr uint16_t HEIGHT    = H;
+  static constexpr uint16_t ROW_BYTES = (W + 7) / 8;
+
+  uint8_t bits[H][ROW_BYTES];
+
+  constexpr bool get(int16_t x, int16_t y) const {
+    return (bits[y][x / 8] >> (7 - x % 8)) & 1;
+  }
+
+  constexpr void set(int16_t x, int16_t y) {
+    if (x >= 0 && y >= 0 && x < W && y < H) {
+      bits[y][x / 8] = static_cast<uint8_t>(bits[y][x / 8] | (0x80 >> (x % 8)));
+    }
+  }
+
+  constexpr void vline(int16_t x, int16_t y, int16_t h) {
+    for (int16_t i = 0; i < h; ++i) {
+      set(x, y + i);
+    }
+  }
+};
+
+using PipMask  = Mask<PIP_SIZE, PIP_SIZE>;
+using FaceMask = Mask<FACE_SIZE, FACE_SIZE>;
+
+// Круг с центром (x0, y0): копия fillCircle + fillCircleHelper из Adafruit_GFX
+template <typename M>
+constexpr void rasterizeCircle(M& mask, int16_t x0, int16_t y0, int16_t r) {
+  mask.vline(x0, y0 - r, 2 * r + 1);
+
+  int16_t f = 1 - r;
+  int16_t ddF_x = 1;
+  int16_t ddF_y = -2 * r;
+  int16_t x = 0;
+  int16_t y = r;
+  int16_t px = x;
+  int16_t py = y;
+  const int16_t delta = 1;
+
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    if (x < (y + 1)) {
+      mask.vline(x0 + x, y0 - y, 2 * y + delta);
+      mask.vline(x0 - x, y0 - y, 2 * y + delta);
+    }
+    if (y != py) {
+      mask.vline(x0 + py, y0 - px, 2 * px + delta);
+      mask.vline(x0 - py, y0 - px, 2 * px + delta);
+      py = y;
+    }
+    px = x;
+  }
+}
+
+constexpr PipMask buildPip() {
+  PipMask mask{};
+  rasterizeCircle(mask, DOT_RADIUS, DOT_RADIUS, DOT_RADIUS);
+  return mask;
+}
+
+constexpr FaceMask buildFace(uint8_t value) {
+  FaceMask mask{};
+  for (uint8_t p = 0; p < POSITION_COUNT; ++p) {
+    if (FACE_MASKS[value] & (1u << p)) {
+      rasterizeCircle(mask, POSITION_X[p] - FACE_OFFSET, POSITION_Y[p] - FACE_OFFSET, DOT_RADIUS);
+    }
+  }
+  return mask;
+}
+
+inline constexpr PipMask PIP = buildPip();
+
+template <uint8_t N>
+struct FaceSet {
+  FaceMask faces[N];
+
+  constexpr const FaceMask& operator[](uint8_t value) const {
+    return faces[value];
+  }
+};
+
+constexpr FaceSet<FACE_COUNT> buildFaces() {
+  FaceSet<FACE_COUNT> set{};
+  for (uint8_t value = 0; value < FACE_COUNT; ++value) {
+    set.faces[value] = buildFace(value);
+  }
+  return set;
+}
+
+inline constexpr FaceSet<FACE_COUNT> FACES = buildFaces();
+
+// ----------------------------------------------------------
+// Вывод спрайтов: одно окно + одна пачка пикселей
+// ----------------------------------------------------------
+
+// Точка в позиции position кубика с левым верхним углом (x, y)
+void drawPip(RenderTarget& target, int16_t x, int16_t y, uint8_t position, uint16_t pipColor, uint16_t fillColor);
+
+// Стереть точку: квадрат PIP_SIZE цветом кубика
+void erasePip(RenderTarget& target, int16_t x, int16_t y, uint8_t position, uint16_t fillColor);
+
+// Вся грань value целиком (включая фон между точками)
+void drawFace(RenderTarget& target, int16_t x, int16_t y, uint8_t value, uint16_t pipColor, uint16_t fillColor);
+
+// Перевести грань oldValue в value: трогаются только позиции из oldMask ^ newMask
+void updateFace(RenderTarget& target, int16_t x, int16_t y, uint8_t oldValue, uint8_t value,
+                uint16_t pipColor, uint16_t fillColor);
+
+// Счётчик операций с точками (окно точки или окно грани) - для оценки
+// нагрузки анимации; сбрасывается вызывающим кодом
+uint32_t pipOperationCount();
+void resetPipOperationCount();
+
+} // namespace PipSprites
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <Adafruit_ST7735.h>
+
+#include "config.h"
+#include "render_target.h"
+#include "st7735_display.h"
+
+// ----------------------------------------------------------
+// Барабан слот-машины на аппаратной прокрутке ST7735
+// (Config::Animation::REEL).
+//
+// Вся панель - кольцо из WIDTH строк развёртки (в ландшафте это
+// столбцы экрана). Лента - бесконечная полоса граней с шагом
+// раскладки Config::Dice; кадр сдвигает начало кольца (VSCRSADD,
+// 3 байта) и дописывает только въехавшие столбцы ленты на место
+// уехавших, да и те - лишь в строках кубиков. Памяти за краем
+// стекла у панели 128x160 нет, поэтому заранее нарисовать ленту
+// целиком некуда.
+//
+// Лента склеена из двух сеток: в начале кубики стоят там, где их
+// нарисовал RollStart, в конце - там же, с итоговыми гранями.
+// Путь ленты кратен ширине кольца, так что итог встаёт на место
+// при нулевом сдвиге и RollResult рисует поверх как обычно.
+// ----------------------------------------------------------
+
+namespace ReelStrip {
+
+// Путь ленты за бросок, столбцов
+inline constexpr uint16_t DISTANCE = Config::Animation::REEL_TURNS * Config::Display::WIDTH;
+
+// Новый бросок: лента в начале; прокрутка прошлого броска, если он
+// не дошёл до итога, выключается
+void reset(St7735Display& panel);
+
+// Итоговая грань кубика index
+void setTarget(uint8_t index, uint8_t value);
+
+// Довести ленту до позиции position (0..DISTANCE), назад она не едет
+void scrollTo(St7735Display& panel, uint16_t position);
+
+// Довести ленту до конца и вернуть панель в обычный режим показа;
+// false - лента не сдвигалась и на панели прежние кубики
+bool finish(St7735Display& panel);
+
+// То, что лента оставила на панели: итоговые грани цветом анимации
+// (теневому кадру - чтобы знать, что уже на экране)
+void drawResult(RenderTarget& target);
+
+} // namespace ReelStrip
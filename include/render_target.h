@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Adafruit_GFX.h>
+
+#include "draw_profiler.h"
+
+// ----------------------------------------------------------
+// Поверхность для отрисовки: дисплей или теневой кадр.
+// Помимо примитивов Adafruit_GFX даёт потоковую запись
+// прямоугольного окна - через неё выводятся спрайты и картинки.
+// ----------------------------------------------------------
+
+class RenderTarget : public Adafruit_GFX {
+public:
+  RenderTarget(int16_t w, int16_t h) : Adafruit_GFX(w, h) {}
+
+  // Окно задаётся в экранных координатах без отсечения;
+  // последующие пиксели заполняют его построчно слева направо
+  virtual void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) = 0;
+  virtual void pushPixels(const uint16_t* pixels, uint32_t count) = 0;
+  virtual void pushColor(uint16_t color, uint32_t count) = 0;
+
+#if defined(DRAW_PROFILER)
+  // Обёртки примитивов Adafruit_GFX для учёта стоимости отрисовки.
+  // Без профилировщика вызовы идут напрямую в Adafruit_GFX.
+  void fillScreen(uint16_t color) override {
+    DRAW_PROFILE_PRIMITIVE(FillScreen);
+    Adafruit_GFX::fillScreen(color);
+  }
+
+  void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+    DRAW_PROFILE_PRIMITIVE(RoundRect);
+    Adafruit_GFX::fillRoundRect(x, y, w, h, r, color);
+  }
+
+  void drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+    DRAW_PROFILE_PRIMITIVE(RoundRect);
+    Adafruit_GFX::drawRoundRect(x, y, w, h, r, color);
+  }
+
+  void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+    DRAW_PROFILE_PRIMITIVE(Triangle);
+    Adafruit_GFX::fillTriangle(x0, y0, x1, y1, x2, y2, color);
+  }
+
+  void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    DRAW_PROFILE_PRIMITIVE(Circle);
+    Adafruit_GFX::fillCircle(x0, y0, r, color);
+  }
+
+  using Print::write;
+  size_t write(uint8_t c) override {
+    DRAW_PROFILE_PRIMITIVE(Text);
+    return Adafruit_GFX::write(c);
+  }
+#endif
+};
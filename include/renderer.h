@@ -0,0 +1,119 @@
+#pragma once
+
+#include <stdint.h>
+
+// ----------------------------------------------------------
+// Отрисовка в отдельной задаче на втором ядре ESP32.
+//
+// loop() не рисует сам: каждое действие на экране - одна
+// компактная команда в кольце без блокировок (один писатель -
+// loop(), один читатель - задача отрисовки). Задача владеет
+// теневым кадром и шиной дисплея, поэтому автомат состояний
+// никогда не ждёт SPI; ждать он может только если кольцо
+// переполнено (такие случаи считаются).
+//
+// На хосте по умолчанию команды выполняются синхронно на
+// present(), чтобы прогон оставался детерминированным;
+// setHostThreaded(true) включает отдельный std::thread.
+// ----------------------------------------------------------
+
+namespace Renderer {
+
+enum class Op : uint8_t {
+  Clear,       // залить экран цветом color
+  Intro,       // интро-экран
+  RollStart,   // рамка кубика a с прошлым значением b перед анимацией
+  RollFrame,   // кадр анимации кубика a: грань c -> b (d - угол кувырка)
+  RollResult,  // итоговая грань b кубика a цветом суммы
+  Timer,       // таймер: a секунд цветом color
+  Alert,       // треугольник алерта (a - видим)
+  Blink,       // мигание алерта способом Config::Alert::BLINK_MODE (a - видим)
+  ReelTarget,  // барабан: итоговая грань b кубика a
+  ReelScroll,  // барабан: лента в позиции color (0..ReelStrip::DISTANCE)
+  Present      // конец кадра: отправить теневой кадр на панель
+};
+
+// Флаги команды
+inline constexpr uint8_t FLAG_FULL_REDRAW = 0x01; // RollFrame: первый кадр; Timer/Alert: очистить экран
+
+struct Command {
+  Op       op;
+  uint8_t  flags;
+  uint8_t  a, b, c, d;
+  uint16_t color;
+};
+
+static_assert(sizeof(Command) <= 8, "Команда отрисовки должна оставаться компактной");
+
+// Инициализация панели и запуск задачи отрисовки
+void begin();
+
+void post(const Command& command);
+
+inline void clear(uint16_t color) {
+  post({Op::Clear, 0, 0, 0, 0, 0, color});
+}
+inline void intro() {
+  post({Op::Intro, 0, 0, 0, 0, 0, 0});
+}
+// Команды броска - по одной на кубик (index < Config::Dice::COUNT)
+inline void rollStart(uint8_t index, uint8_t value, uint16_t color) {
+  post({Op::RollStart, 0, index, value, 0, 0, color});
+}
+inline void rollFrame(uint8_t index, uint8_t oldValue, uint8_t value, uint8_t angle, bool first) {
+  post({Op::RollFrame, static_cast<uint8_t>(first ? FLAG_FULL_REDRAW : 0), index, value, oldValue, angle, 0});
+}
+inline void rollResult(uint8_t index, uint8_t value, uint16_t color) {
+  post({Op::RollResult, 0, index, value, 0, 0, color});
+}
+// Барабан (Config::Animation::REEL) вместо кадров RollFrame
+inline void reelTarget(uint8_t index, uint8_t value) {
+  post({Op::ReelTarget, 0, index, value, 0, 0, 0});
+}
+inline void reelScroll(uint16_t position) {
+  post({Op::ReelScroll, 0, 0, 0, 0, 0, position});
+}
+inline void timer(uint8_t seconds, uint16_t color, bool fullRedraw) {
+  post({Op::Timer, static_cast<uint8_t>(fullRedraw ? FLAG_FULL_REDRAW : 0), seconds, 0, 0, 0, color});
+}
+inline void alert(bool visible, bool clearFirst) {
+  post({Op::Alert, static_cast<uint8_t>(clearFirst ? FLAG_FULL_REDRAW : 0), visible, 0, 0, 0, 0});
+}
+inline void blink(bool visible) {
+  post({Op::Blink, 0, visible, 0, 0, 0, 0});
+}
+// Конец кадра; если с прошлого present() ничего не ставилось - не отправляется
+void present();
+
+// Дождаться, пока задача выполнит всё поставленное (снимки экрана, отладка)
+void waitIdle();
+
+// Сколько раз loop() ждал места в переполненном кольце
+uint32_t stallCount();
+
+// Время отрисовки кадров (исполнение команд от present() до present()
+// включительно), мкс; пишет задача отрисовки
+struct FrameStats {
+  uint32_t frames;
+  uint32_t lastUs;
+  uint32_t maxUs;
+  uint64_t totalUs;
+  uint32_t rollPipOperations; // вывод точек за последний бросок (PipSprites)
+};
+
+FrameStats frameStats();
+
+// Сколько кадров поставлено, но ещё не отправлено на панель
+uint32_t pendingFrames();
+
+#if !defined(ESP32)
+// Хост: выполнять команды в отдельном std::thread (включать до begin());
+// выключение дожидается очереди и останавливает поток
+void setHostThreaded(bool threaded);
+
+// Хост: каждый кадр "рисуется" ещё costUs виртуального времени
+// (синхронный режим) - для проверки отставания анимации
+void setHostFrameCostUs(uint32_t costUs);
+#endif
+
+} // namespace Renderer
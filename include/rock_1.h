@@ -1,12 +1,11 @@
 // ОРИГИНАЛЬНЫЙ, а не Clint Eastwood
-inline constexpr int OMNI_STYLE_LOOP[] = {
-  466, 250,  // Bb
-  415, 250,  // Ab
-  466, 250,  // Bb
-  311, 300,  // Eb
-  0,   120,
-  370, 220,  // F#
-  415, 220,  // Ab
-  466, 320   // Bb
+inline constexpr Source OMNI_STYLE_LOOP[] = {
+  {pitch(Note::Bb, 4), 250},
+  {pitch(Note::Ab, 4), 250},
+  {pitch(Note::Bb, 4), 250},
+  {pitch(Note::Eb, 4), 300},
+  {REST,               120},
+  {pitch(Note::Fs, 4), 220},
+  {pitch(Note::Ab, 4), 220},
+  {pitch(Note::Bb, 4), 320}
 };
-inline constexpr int OMNI_STYLE_LOOP_SIZE = sizeof(OMNI_STYLE_LOOP)/sizeof(int)/2;
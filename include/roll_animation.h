@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <Adafruit_ST7735.h>
+
+#include "config.h"
+
+// ----------------------------------------------------------
+// Анимация броска с фиксированным бюджетом времени.
+//
+// Бросок всегда длится Config::Animation::ROLL_DURATION_MS от
+// нажатия до итоговой грани. Моменты смены граней заданы кривой
+// замедления (EASE_OUT_PERCENT): шаг между кадрами растёт к концу.
+// Если loop() опоздал на несколько моментов, они сливаются в один
+// кадр; если задача отрисовки ещё не отправила прошлый кадр, новый
+// пропускается. Итог приходит точно в срок, щелчки идут только с
+// показанными кадрами.
+// ----------------------------------------------------------
+
+namespace RollAnimation {
+
+enum class Step : uint8_t {
+  Frame,    // поставлен кадр (нужен щелчок)
+  Skipped,  // кадр пропущен: отрисовка или loop() отстают
+  Finished  // бюджет исчерпан - пора рисовать итог
+};
+
+struct Stats {
+  uint32_t rolls;
+  uint32_t frames;       // показано промежуточных кадров, всего
+  uint32_t merged;       // моментов, слитых из-за опоздания loop()
+  uint32_t skipped;      // кадров, пропущенных из-за отставания отрисовки
+  uint32_t maxLateUs;    // наибольшее опоздание тика относительно расписания
+  uint32_t lastFrames;   // показано за последний бросок
+};
+
+// Начать бросок: shown - грани на экране, target - итог
+void start(const uint8_t* shown, const uint8_t* target, uint64_t startUs);
+
+// Срок первого тика после start() или следующего после step()
+uint64_t nextDeadlineUs();
+
+// Тик по расписанию (deadlineUs - его срок, nowUs - фактическое время)
+Step step(uint64_t deadlineUs, uint64_t nowUs);
+
+// Итоговые грани текущего броска
+const uint8_t* target();
+
+const Stats& stats();
+
+} // namespace RollAnimation
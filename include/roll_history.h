@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+
+class Preferences;
+
+// ----------------------------------------------------------
+// История бросков двух кубиков.
+//
+// Последние Config::History::CAPACITY бросков хранятся в RAM в
+// кольце по 6 бит на бросок ((d1-1)*6 + (d2-1) < 36), рядом -
+// счётчики сумм 2..12 за всё время. В NVS всё это уходит одним
+// блобом, но не на каждый бросок: record() только копит, а
+// flush() вызывает loop() пачкой или в простое без бросков, вне
+// анимации, показа результата и таймера.
+// Число записей в NVS и записанные байты ведутся в том же блобе -
+// по ним видно износ flash. Перед ESP.restart() - flush().
+// ----------------------------------------------------------
+
+namespace RollHistory {
+
+struct Stats {
+  uint32_t totalRolls;   // за всё время
+  uint32_t nvsWrites;    // сколько раз блоб записан в NVS
+  uint32_t nvsBytes;     // сколько байт записано всего
+  uint16_t pending;      // бросков, ещё не сохранённых в NVS
+};
+
+// Загрузить историю из NVS (пространство уже открыто)
+void begin(Preferences& preferences);
+
+// Запомнить бросок (значения 1..6) в RAM
+void record(uint8_t dice1, uint8_t dice2);
+
+// Сколько бросков в кольце
+uint16_t size();
+
+// Бросок age назад (0 - последний); false - такого нет
+bool recent(uint16_t age, uint8_t& dice1, uint8_t& dice2);
+
+// Выпадений суммы sum (2..12) за всё время
+uint32_t sumCount(uint8_t sum);
+
+// Набралась ли пачка для записи
+bool batchReady();
+
+// Записать несохранённое в NVS (без изменений - ничего не делает)
+void flush();
+
+const Stats& stats();
+
+} // namespace RollHistory
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+
+// ----------------------------------------------------------
+// Планировщик задач с абсолютными сроками на 64-битных часах
+// esp_timer (микросекунды с момента старта).
+//
+// Каждая задача - слот с фиксированным номером Job: у неё есть
+// обработчик и, если она взведена, срок выполнения. Обработчик
+// получает свой срок и взводит следующий запуск от него, а не от
+// текущего времени, поэтому периодические задачи не накапливают
+// сдвиг. loop() между событиями спит до ближайшего срока или до
+// пробуждения из прерывания (wakeFromIsr).
+// ----------------------------------------------------------
+
+namespace Scheduler {
+
+enum class Job : uint8_t {
+  AnimationFrame,  // кадр анимации броска
+  ResultTimeout,   // конец показа результата
+  TimerSecond,     // очередная секунда таймера
+  AlertBlink,      // мигание алерта
+  ButtonCheck,     // конец антидребезга / порог долгого нажатия
+  HistoryFlush,    // запись истории бросков в NVS
+  COUNT
+};
+
+using Callback = void (*)(uint64_t deadlineUs);
+
+constexpr uint64_t msToUs(uint64_t ms) {
+  return ms * 1000ULL;
+}
+
+// Текущее время, мкс
+uint64_t nowUs();
+
+// Подготовка: запоминает задачу loop() и создаёт таймер пробуждения
+void begin();
+
+void attach(Job job, Callback callback);
+
+// Взвести задачу на абсолютный срок (повторный вызов переносит срок)
+void at(Job job, uint64_t deadlineUs);
+void cancel(Job job);
+bool pending(Job job);
+
+// Выполнить все задачи, срок которых наступил, в порядке сроков
+void runDue();
+
+// Спать до ближайшего срока, но не дольше maxSleepUs;
+// раньше - если было пробуждение из прерывания
+void waitForNext(uint64_t maxSleepUs);
+
+// Разбудить loop() (вызывается из ISR)
+void wakeFromIsr();
+
+#if !defined(ESP32)
+// Хост: сон на виртуальных часах не заходит дальше этого момента
+// (следующее событие сценария host_main.cpp)
+void setHostWakeLimit(uint64_t us);
+#endif
+
+} // namespace Scheduler
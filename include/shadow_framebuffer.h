@@ -0,0 +1,139 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <Adafruit_ST7735.h>
+
+#include "config.h"
+#include "render_target.h"
+
+// ----------------------------------------------------------
+// Теневой кадр 160x128 в 4 бита на пиксель (индексы палитры).
+// Вся отрисовка идёт в память; запись, которая действительно
+// меняет пиксели, отмечает их куски строки (по DIRTY_CHUNK
+// пикселей) в битовой маске этой строки. flush() отправляет на
+// панель только отмеченные куски, соседние строки с одинаковой
+// маской объединяются в общие окна.
+// ----------------------------------------------------------
+
+namespace ShadowPalette {
+
+struct Table {
+  uint16_t colors[16];
+  uint8_t  size;
+  uint8_t  unique; // сколько разных цветов встретилось (для проверки)
+};
+
+// Палитра собирается на этапе компиляции из Config::Colors без повторов
+constexpr Table build() {
+  const uint16_t source[] = {
+    Config::Colors::BACKGROUND,
+    Config::Colors::DICE_FILL,
+    Config::Colors::DICE_BORDER,
+    Config::Colors::DICE_PIP,
+    Config::Colors::TIMER_TEXT,
+    Config::Colors::ALERT,
+    Config::Colors::TITLE_TEXT,
+    Config::Colors::HINT_TEXT,
+    Config::Colors::DiceSum::SUM_2_12,
+    Config::Colors::DiceSum::SUM_3_11,
+    Config::Colors::DiceSum::SUM_4_10,
+    Config::Colors::DiceSum::SUM_5_9,
+    Config::Colors::DiceSum::SUM_6_8,
+    Config::Colors::DiceSum::SUM_7,
+    Config::Colors::TimerColor::LEVEL_OK,
+    Config::Colors::TimerColor::LEVEL_WARN,
+    Config::Colors::TimerColor::LEVEL_URGENT,
+    Config::Colors::TimerColor::LEVEL_CRITICAL,
+  };
+
+  Table table{};
+  for (uint16_t color : source) {
+    bool known = false;
+    for (uint8_t i = 0; i < table.size; ++i) {
+      known = known || table.colors[i] == color;
+    }
+    if (!known) {
+      if (table.size < 16) {
+        table.colors[table.size++] = color;
+      }
+      ++table.unique;
+    }
+  }
+  return table;
+}
+
+inline constexpr Table TABLE = build();
+
+static_assert(TABLE.unique <= 16, "Config::Colors содержит больше 16 разных цветов");
+
+} // namespace ShadowPalette
+
+class ShadowFramebuffer : public RenderTarget {
+public:
+  static constexpr uint16_t WIDTH  = Config::Display::WIDTH;
+  static constexpr uint16_t HEIGHT = Config::Display::HEIGHT;
+  static constexpr uint16_t ROW_BYTES = WIDTH / 2;
+
+  // Кусок строки на бит маски изменений
+  static constexpr uint16_t DIRTY_CHUNK = 8;
+
+  static_assert(WIDTH % 2 == 0, "Ширина теневого кадра должна быть чётной");
+  static_assert(WIDTH % DIRTY_CHUNK == 0 && WIDTH / DIRTY_CHUNK <= 32,
+                "Маска изменений строки должна помещаться в uint32_t");
+
+  ShadowFramebuffer();
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void writePixel(int16_t x, int16_t y, uint16_t color) override;
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) override;
+  void pushPixels(const uint16_t* pixels, uint32_t count) override;
+  void pushColor(uint16_t color, uint32_t count) override;
+
+  // Отправить на панель только изменённые с прошлого flush() куски.
+  // Возвращает число отправленных пикселей.
+  uint32_t flush(RenderTarget& panel);
+
+  // Содержимое панели неизвестно (после сброса или прямой записи мимо
+  // теневого кадра) - следующий flush() отправит кадр целиком
+  void invalidate();
+
+  // Панель уже показывает текущий кадр (его записали мимо теневого
+  // кадра, см. ReelStrip) - снять отметки без передачи
+  void accept();
+
+  // Статистика последнего flush()
+  uint32_t lastFlushPixels  = 0;
+  uint16_t lastFlushWindows = 0;
+
+private:
+  static uint8_t colorIndex(uint16_t color);
+  void setIndex(int16_t x, int16_t y, uint8_t index);
+  void fillIndexSpan(int16_t x, int16_t y, int16_t w, uint8_t index);
+  void markChanged(int16_t y, uint32_t chunks);
+  void sendRun(RenderTarget& panel, uint32_t chunks, uint16_t y0, uint16_t y1);
+  void sendWindow(RenderTarget& panel, uint16_t x0, uint16_t x1, uint16_t y0, uint16_t y1);
+
+  // Один кадр: что на панели, видно по маскам изменений
+  // (10 КБ кадра + 512 байт масок вместо второго кадра на 10 КБ)
+  uint8_t  frame[ROW_BYTES * HEIGHT];
+  uint32_t dirtyChunks[HEIGHT];
+
+  // Строки с отметками: dirtyMin..dirtyMax (пусто при dirtyMin > dirtyMax)
+  int16_t dirtyMin = HEIGHT;
+  int16_t dirtyMax = -1;
+
+  // Окно потоковой записи
+  uint16_t windowX = 0;
+  uint16_t windowY = 0;
+  uint16_t windowW = 0;
+  uint16_t windowH = 0;
+  uint32_t windowPos = 0;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+// ----------------------------------------------------------
+// Кольцевой буфер без блокировок для одного писателя и одного
+// читателя (например, ISR -> loop()). Писатель двигает только
+// head, читатель - только tail; порядок записи элемента и
+// индекса гарантируют release/acquire.
+// ----------------------------------------------------------
+
+template <typename T, uint16_t N>
+class SpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "Размер кольца - степень двойки");
+
+public:
+  // Писатель: false, если буфер полон (элемент отброшен)
+  bool push(const T& item) {
+    const uint16_t head = this->head.load(std::memory_order_relaxed);
+    if (static_cast<uint16_t>(head - tail.load(std::memory_order_acquire)) == N) {
+      return false;
+    }
+    items[head & (N - 1)] = item;
+    this->head.store(static_cast<uint16_t>(head + 1), std::memory_order_release);
+    return true;
+  }
+
+  // Читатель: false, если буфер пуст
+  bool pop(T& item) {
+    const uint16_t tail = this->tail.load(std::memory_order_relaxed);
+    if (tail == head.load(std::memory_order_acquire)) {
+      return false;
+    }
+    item = items[tail & (N - 1)];
+    this->tail.store(static_cast<uint16_t>(tail + 1), std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+  }
+
+  uint16_t size() const {
+    return static_cast<uint16_t>(head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire));
+  }
+
+  static constexpr uint16_t capacity() { return N; }
+
+private:
+  T items[N];
+  std::atomic<uint16_t> head{0};
+  std::atomic<uint16_t> tail{0};
+};
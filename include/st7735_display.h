@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Adafruit_ST7735.h>
+
+#include "render_target.h"
+#include "tft_bus.h"
+
+// ----------------------------------------------------------
+// Драйвер ST7735 поверх абстрактной шины TftBus.
+// Повторяет последовательность инициализации и поток байт
+// Adafruit_ST7735 (initR, setRotation, окна CASET/RASET/RAMWR),
+// но отправляет их через выбранную шину: программный SPI
+// или аппаратный VSPI с DMA.
+// Все примитивы Adafruit_GFX (текст, круги, треугольники...)
+// работают без изменений.
+// ----------------------------------------------------------
+
+class St7735Display : public RenderTarget {
+public:
+  explicit St7735Display(TftBus& bus);
+
+  // Инициализация контроллера (аналог Adafruit_ST7735::initR)
+  void initR(uint8_t options);
+
+  void setRotation(uint8_t r) override;
+  void invertDisplay(bool invert) override;
+  void enableDisplay(bool enable);
+
+  // Аппаратная прокрутка по строкам развёртки (NATIVE_HEIGHT строк; в
+  // ландшафтных поворотах это столбцы экрана). top и bottom строк стоят
+  // на месте, lines строк между ними идут по кругу (VSCRDEF)
+  void setScrollArea(uint16_t top, uint16_t lines, uint16_t bottom);
+  // Первой строкой области показать строку памяти line (VSCRSADD)
+  void scrollTo(uint16_t line);
+  // Выход из прокрутки в обычный режим показа (NORON)
+  void endScroll();
+  // MY в MADCTL (повороты 0 и 1): адреса окна идут навстречу строкам
+  // памяти, и увеличение line сдвигает картинку к концу экранной оси
+  bool scrollMirrored() const { return rotation <= 1; }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void writePixel(int16_t x, int16_t y, uint16_t color) override;
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+
+  // Низкоуровневый доступ для спрайтов и потоковой отрисовки:
+  // окно задаётся в экранных координатах без отсечения.
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) override;
+  void pushPixels(const uint16_t* pixels, uint32_t count) override;
+  void pushColor(uint16_t color, uint32_t count) override;
+  void sendCommand(uint8_t cmd, const uint8_t* data = nullptr, uint8_t len = 0);
+
+  // Пиксели в порядке линии прямо из буфера (см. TftBus::queuePixels)
+  uint32_t queuePixels(const uint16_t* wirePixels, uint32_t count) { return tftBus.queuePixels(wirePixels, count); }
+  void waitQueued(uint32_t token) { tftBus.waitQueued(token); }
+
+  // Дождаться окончания всех передач на шине
+  void flush();
+
+  TftBus& bus() { return tftBus; }
+
+private:
+  void runCommandList(const uint8_t* list);
+
+  TftBus& tftBus;
+  uint8_t tabColor = 0;
+  uint8_t colStart = 0;
+  uint8_t rowStart = 0;
+  uint8_t xStart   = 0;
+  uint8_t yStart   = 0;
+};
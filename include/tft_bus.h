@@ -0,0 +1,133 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ----------------------------------------------------------
+// Шина дисплея: минимальный набор операций, через который
+// драйвер St7735Display отправляет байты на контроллер.
+// Цвета передаются в "родном" порядке байт (uint16_t),
+// перестановка в big-endian - забота конкретной шины.
+// ----------------------------------------------------------
+
+class TftBus {
+public:
+  virtual ~TftBus() = default;
+
+  // Настройка пинов, периферии и аппаратный сброс дисплея
+  virtual void begin() = 0;
+
+  // Байт команды (DC = 0)
+  virtual void writeCommand(uint8_t cmd) = 0;
+
+  // Байты параметров (DC = 1)
+  virtual void writeData(const uint8_t* data, size_t len) = 0;
+
+  // count пикселей одного цвета
+  virtual void writeColor(uint16_t color, uint32_t count) = 0;
+
+  // count пикселей из буфера
+  virtual void writePixels(const uint16_t* pixels, uint32_t count) = 0;
+
+  // count пикселей, уже переставленных в порядок линии (big-endian),
+  // передаются прямо из буфера вызывающего, без копирования. Буфер
+  // нельзя менять, пока не вернётся waitQueued() с полученной меткой.
+  // По умолчанию - обычная синхронная передача через writePixels()
+  virtual uint32_t queuePixels(const uint16_t* wirePixels, uint32_t count) {
+    uint16_t chunk[32];
+    while (count > 0) {
+      const uint32_t part = count < 32 ? count : 32;
+      for (uint32_t i = 0; i < part; ++i) {
+        chunk[i] = static_cast<uint16_t>((wirePixels[i] >> 8) | (wirePixels[i] << 8));
+      }
+      writePixels(chunk, part);
+      wirePixels += part;
+      count      -= part;
+    }
+    return 0;
+  }
+
+  virtual void waitQueued(uint32_t token) {}
+
+  // Дождаться завершения всех поставленных в очередь передач
+  virtual void flush() {}
+};
+
+// ----------------------------------------------------------
+// Программный SPI (поведение исходного конструктора Adafruit_ST7735
+// с пинами MOSI/SCLK)
+// ----------------------------------------------------------
+
+class SoftSpiBus : public TftBus {
+public:
+  SoftSpiBus(uint8_t cs, uint8_t dc, uint8_t mosi, uint8_t sclk, uint8_t rst);
+
+  void begin() override;
+  void writeCommand(uint8_t cmd) override;
+  void writeData(const uint8_t* data, size_t len) override;
+  void writeColor(uint16_t color, uint32_t count) override;
+  void writePixels(const uint16_t* pixels, uint32_t count) override;
+
+private:
+  void writeByte(uint8_t value);
+
+  uint8_t csPin;
+  uint8_t dcPin;
+  uint8_t mosiPin;
+  uint8_t sclkPin;
+  uint8_t rstPin;
+};
+
+#if defined(ESP32)
+#include <driver/spi_master.h>
+
+// ----------------------------------------------------------
+// Аппаратный VSPI (SPI3_HOST) с DMA.
+// Все передачи ставятся в очередь драйвера spi_master: заливки
+// и блиты отдаются кусками по TFT_DMA_CHUNK_PIXELS из двух
+// DMA-буферов, пока CPU готовит следующий кусок.
+// ----------------------------------------------------------
+
+class Esp32DmaBus : public TftBus {
+public:
+  Esp32DmaBus(uint8_t cs, uint8_t dc, uint8_t mosi, uint8_t sclk, uint8_t rst, uint32_t freqHz);
+
+  void begin() override;
+  void writeCommand(uint8_t cmd) override;
+  void writeData(const uint8_t* data, size_t len) override;
+  void writeColor(uint16_t color, uint32_t count) override;
+  void writePixels(const uint16_t* pixels, uint32_t count) override;
+  uint32_t queuePixels(const uint16_t* wirePixels, uint32_t count) override;
+  void waitQueued(uint32_t token) override;
+  void flush() override;
+
+private:
+  static constexpr uint8_t BUFFER_COUNT = 2;
+
+  spi_transaction_t* nextTransaction();
+  void queue(spi_transaction_t* t);
+  void waitOne();
+  uint16_t* acquireBuffer(uint8_t& index);
+
+  uint8_t csPin;
+  uint8_t dcPin;
+  uint8_t mosiPin;
+  uint8_t sclkPin;
+  uint8_t rstPin;
+  uint32_t frequency;
+
+  spi_device_handle_t device = nullptr;
+
+  // Кольцо структур транзакций: драйвер возвращает их строго по порядку
+  spi_transaction_t* transactions = nullptr;
+  uint8_t  transactionHead = 0;
+  uint8_t  inFlight        = 0;
+  uint32_t submitted       = 0;
+  uint32_t completed       = 0;
+
+  // DMA-буферы и номер последней транзакции, которая их читает
+  uint16_t* buffers[BUFFER_COUNT] = {};
+  uint32_t  bufferFence[BUFFER_COUNT] = {};
+  uint8_t   nextBuffer = 0;
+};
+#endif
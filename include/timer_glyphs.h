@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <Adafruit_ST7735.h>
+
+#include "config.h"
+#include "render_target.h"
+
+// ----------------------------------------------------------
+// Кэш цифр таймера: глифы '0'..'9' встроенного шрифта GFX,
+// заранее увеличенные в Config::Timer::TEXT_SIZE раз и сжатые
+// RLE на этапе компиляции. Цвет подставляется при выводе,
+// поэтому смена цвета таймера не требует растеризации.
+// ----------------------------------------------------------
+
+namespace TimerGlyphs {
+
+inline constexpr uint8_t SCALE = Config::Timer::TEXT_SIZE;
+
+// Ячейка символа шрифта 6x8 (5 столбцов глифа + столбец-пробел)
+inline constexpr uint16_t CELL_W = 6 * SCALE;
+inline constexpr uint16_t CELL_H = 8 * SCALE;
+
+// Глифы цифр из glcdfont.c: 5 столбцов, младший бит - верхняя строка
+inline constexpr uint8_t FONT_DIGITS[10][5] = {
+  {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00},
+  {0x72, 0x49, 0x49, 0x49, 0x46}, {0x21, 0x41, 0x49, 0x4D, 0x33},
+  {0x18, 0x14, 0x12, 0x7F, 0x10}, {0x27, 0x45, 0x45, 0x45, 0x39},
+  {0x3C, 0x4A, 0x49, 0x49, 0x31}, {0x41, 0x21, 0x11, 0x09, 0x07},
+  {0x36, 0x49, 0x49, 0x49, 0x36}, {0x46, 0x49, 0x49, 0x29, 0x1E},
+};
+
+// Пиксель увеличенной ячейки: true - цвет цифры, false - фон
+constexpr bool glyphPixel(uint8_t digit, uint16_t x, uint16_t y) {
+  const uint16_t column = x / SCALE;
+  const uint16_t row    = y / SCALE;
+  return column < 5 && ((FONT_DIGITS[digit][column] >> row) & 1);
+}
+
+// RLE в порядке развёртки: длины серий чередуются фон/цифра,
+// первая серия - фон (может быть нулевой). Серии длиннее 255
+// разбиваются через серию нулевой длины другого цвета.
+constexpr uint16_t encode(uint8_t digit, uint8_t* out) {
+  uint16_t length = 0;
+  bool     color  = false;
+  uint16_t run    = 0;
+
+  for (uint32_t i = 0; i < static_cast<uint32_t>(CELL_W) * CELL_H; ++i) {
+    const bool pixel = glyphPixel(digit, i % CELL_W, i / CELL_W);
+    if (pixel != color || run == 255) {
+      if (out) {
+        out[length] = static_cast<uint8_t>(run);
+      }
+      ++length;
+      if (pixel == color) {
+        // Серия переполнена: вставляем пустую серию другого цвета
+        if (out) {
+          out[length] = 0;
+        }
+        ++length;
+      }
+      color = pixel;
+      run   = 0;
+    }
+    ++run;
+  }
+  if (out) {
+    out[length] = static_cast<uint8_t>(run);
+  }
+  return ++length;
+}
+
+constexpr uint16_t totalLength() {
+  uint16_t total = 0;
+  for (uint8_t d = 0; d < 10; ++d) {
+    total += encode(d, nullptr);
+  }
+  return total;
+}
+
+inline constexpr uint16_t RLE_BYTES = totalLength();
+
+struct Atlas {
+  uint8_t  runs[RLE_BYTES];
+  uint16_t offset[11];  // начало серий цифры d; offset[10] - конец
+};
+
+constexpr Atlas buildAtlas() {
+  Atlas atlas{};
+  uint16_t position = 0;
+  for (uint8_t d = 0; d < 10; ++d) {
+    atlas.offset[d] = position;
+    position += encode(d, &atlas.runs[position]);
+  }
+  atlas.offset[10] = position;
+  return atlas;
+}
+
+inline constexpr Atlas ATLAS = buildAtlas();
+
+// Вывести цифру в ячейку с левым верхним углом (x, y)
+void drawDigit(RenderTarget& target, int16_t x, int16_t y, uint8_t digit, uint16_t color, uint16_t background);
+
+} // namespace TimerGlyphs
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <Adafruit_ST7735.h>
+
+#include "config.h"
+#include "pip_sprites.h"
+#include "render_target.h"
+
+// ----------------------------------------------------------
+// Атлас кувыркающегося кубика: грани с точками, повёрнутые на
+// ANGLE_COUNT углов от 0 до 90 градусов и уменьшенные так, чтобы
+// повёрнутый кубик оставался в квадрате SIZE x SIZE (кажется,
+// что он катится и отскакивает). Размеры - из Config::Dice::SIZE,
+// RADIUS и DOT_RADIUS.
+//
+// Спрайты растеризуются и сжимаются RLE на этапе компиляции и
+// лежат во flash. Байт серии: 2 бита цвета палитры (фон, тело,
+// точка, рамка) и 6 бит длины - 1; серии не переходят через
+// строку. Вывод идёт построчно прямо в окно дисплея: нужен
+// буфер только на одну строку.
+// ----------------------------------------------------------
+
+namespace TumbleAtlas {
+
+inline constexpr uint8_t  ANGLE_COUNT = 6;    // шаг 15 градусов
+inline constexpr uint16_t SIZE        = Config::Dice::SIZE;
+
+// Только грани, которые рисуются точками
+inline constexpr uint8_t FACE_COUNT = PipSprites::FACE_COUNT;
+
+// Объём атласа во flash, байт
+uint32_t atlasBytes();
+
+// Кадр кувырка: грань value под углом angle (по модулю ANGLE_COUNT)
+// в квадрате SIZE x SIZE с левым верхним углом (x, y)
+void draw(RenderTarget& target, int16_t x, int16_t y, uint8_t angle, uint8_t value,
+          uint16_t fillColor, uint16_t background);
+
+// Столбцы [column, column + count) грани value без поворота (угол 0 -
+// обычный кубик SIZE x SIZE) для ленты барабана: пиксель строки y
+// столбца column + i уходит в out[y * stride + i]
+void columns(uint8_t value, uint16_t column, uint16_t count, uint16_t fillColor, uint16_t background,
+             uint16_t* out, uint16_t stride);
+
+} // namespace TumbleAtlas
@@ -0,0 +1,243 @@
+#include "Arduino.h"
+
+#include <atomic>
+#include <deque>
+
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "host_pins.h"
+
+// ----------------------------------------------------------
+// Виртуальные часы
+// ----------------------------------------------------------
+
+namespace {
+  // Читается и потоком отрисовки (--render-thread)
+  std::atomic<uint64_t> clockUs{0};
+}
+
+uint64_t VirtualClock::nowUs() { return clockUs; }
+void VirtualClock::advanceUs(uint64_t us) { setUs(clockUs + us); }
+
+// По пути к новому времени срабатывают таймеры esp_timer, каждый - в свой срок
+void VirtualClock::setUs(uint64_t us) {
+  static bool firing = false;
+  if (!firing) {
+    firing = true;
+    esp_timer_cb_t callback;
+    void*          arg;
+    uint64_t       deadline;
+    while (HostTimers::takeDue(us, callback, arg, deadline)) {
+      clockUs = std::max<uint64_t>(clockUs, deadline);
+      callback(arg);
+    }
+    firing = false;
+  }
+  clockUs = std::max<uint64_t>(clockUs, us);
+}
+
+// ----------------------------------------------------------
+// GPIO
+// ----------------------------------------------------------
+
+namespace {
+  constexpr uint8_t PIN_COUNT = 40;
+
+  uint8_t pinLevels[PIN_COUNT];
+  bool    pinLevelsReady = false;
+  void (*pinHandlers[PIN_COUNT])() = {};
+  int     pinHandlerModes[PIN_COUNT] = {};
+
+  void ensurePins() {
+    if (!pinLevelsReady) {
+      for (uint8_t& level : pinLevels) {
+        level = HIGH;
+      }
+      pinLevelsReady = true;
+    }
+  }
+
+  unsigned int currentTone = 0;
+  uint32_t     toneCalls   = 0;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+  ensurePins();
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  ensurePins();
+  if (pin < PIN_COUNT) {
+    pinLevels[pin] = value ? HIGH : LOW;
+  }
+}
+
+int digitalRead(uint8_t pin) {
+  ensurePins();
+  return pin < PIN_COUNT ? pinLevels[pin] : LOW;
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode) {
+  if (pin < PIN_COUNT) {
+    pinHandlers[pin]     = handler;
+    pinHandlerModes[pin] = mode;
+  }
+}
+
+void detachInterrupt(uint8_t pin) {
+  if (pin < PIN_COUNT) {
+    pinHandlers[pin] = nullptr;
+  }
+}
+
+void HostPins::setInput(uint8_t pin, uint8_t level) {
+  ensurePins();
+  if (pin >= PIN_COUNT) {
+    return;
+  }
+  const uint8_t previous = pinLevels[pin];
+  pinLevels[pin] = level ? HIGH : LOW;
+  if (previous == pinLevels[pin] || pinHandlers[pin] == nullptr) {
+    return;
+  }
+  const int mode = pinHandlerModes[pin];
+  const bool rising = pinLevels[pin] == HIGH;
+  if (mode == CHANGE || (mode == RISING && rising) || (mode == FALLING && !rising)) {
+    pinHandlers[pin]();
+  }
+}
+
+uint8_t HostPins::outputLevel(uint8_t pin) {
+  ensurePins();
+  return pin < PIN_COUNT ? pinLevels[pin] : LOW;
+}
+
+// ----------------------------------------------------------
+// Звук
+// ----------------------------------------------------------
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+  (void)pin;
+  (void)duration;
+  currentTone = frequency;
+  ++toneCalls;
+}
+
+void noTone(uint8_t pin) {
+  (void)pin;
+  currentTone = 0;
+}
+
+namespace {
+  constexpr uint8_t LEDC_CHANNELS = 16;
+
+  uint32_t ledcFrequency[LEDC_CHANNELS] = {};
+  uint32_t ledcDuty[LEDC_CHANNELS]      = {};
+}
+
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolutionBits) {
+  return ledcChangeFrequency(channel, freq, resolutionBits);
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {
+  (void)pin;
+  (void)channel;
+}
+
+uint32_t ledcChangeFrequency(uint8_t channel, uint32_t freq, uint8_t resolutionBits) {
+  (void)resolutionBits;
+  if (channel < LEDC_CHANNELS) {
+    ledcFrequency[channel] = freq;
+    if (ledcDuty[channel] > 0) {
+      currentTone = freq;
+    }
+  }
+  return freq;
+}
+
+// Звук начинается, когда скважность уходит с нуля: это и считается "нотой"
+void ledcWrite(uint8_t channel, uint32_t duty) {
+  if (channel >= LEDC_CHANNELS) {
+    return;
+  }
+  if (ledcDuty[channel] == 0 && duty > 0) {
+    ++toneCalls;
+  }
+  ledcDuty[channel] = duty;
+  currentTone = duty > 0 ? ledcFrequency[channel] : 0;
+}
+
+unsigned int HostPins::lastToneFrequency() { return currentTone; }
+uint32_t HostPins::toneCount() { return toneCalls; }
+
+// ----------------------------------------------------------
+// Случайные числа
+// ----------------------------------------------------------
+
+long random(long howbig) {
+  if (howbig <= 0) {
+    return 0;
+  }
+  return rand() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) {
+    return howsmall;
+  }
+  return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) {
+    srand(static_cast<unsigned>(seed));
+  }
+}
+
+uint32_t esp_random() {
+  // xorshift32: воспроизводимый "аппаратный" шум для хоста
+  static uint32_t state = 0x9E3779B9u;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// ----------------------------------------------------------
+// Serial / ESP
+// ----------------------------------------------------------
+
+namespace {
+  std::deque<char> serialInput;
+}
+
+HardwareSerial Serial;
+EspClass ESP;
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (!muted) {
+    fputc(c, stdout);
+  }
+  return 1;
+}
+
+int HardwareSerial::available() {
+  return static_cast<int>(serialInput.size());
+}
+
+int HardwareSerial::read() {
+  if (serialInput.empty()) {
+    return -1;
+  }
+  const char c = serialInput.front();
+  serialInput.pop_front();
+  return static_cast<unsigned char>(c);
+}
+
+void HardwareSerial::inject(const char* text) {
+  while (*text) {
+    serialInput.push_back(*text++);
+  }
+}
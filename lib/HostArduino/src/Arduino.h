@@ -0,0 +1,95 @@
+#pragma once
+
+// ----------------------------------------------------------
+// Заглушка Arduino API для сборки [env:native].
+// Время берётся из виртуальных часов (virtual_clock.h):
+// delay() не спит, а сдвигает часы вперёд.
+// ----------------------------------------------------------
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "Print.h"
+#include "virtual_clock.h"
+
+using std::max;
+using std::min;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+#define RISING  0x01
+#define FALLING 0x02
+#define CHANGE  0x03
+
+#define IRAM_ATTR
+
+inline unsigned long millis() { return static_cast<unsigned long>(VirtualClock::nowUs() / 1000ULL); }
+inline unsigned long micros() { return static_cast<unsigned long>(VirtualClock::nowUs()); }
+inline void delay(unsigned long ms) { VirtualClock::advanceUs(static_cast<uint64_t>(ms) * 1000ULL); }
+inline void delayMicroseconds(unsigned int us) { VirtualClock::advanceUs(us); }
+inline void yield() {}
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode);
+void detachInterrupt(uint8_t pin);
+inline uint8_t digitalPinToInterrupt(uint8_t pin) { return pin; }
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+// LEDC (API arduino-esp32 2.x): звук на хосте - частота и скважность канала
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolutionBits);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+uint32_t ledcChangeFrequency(uint8_t channel, uint32_t freq, uint8_t resolutionBits);
+void ledcWrite(uint8_t channel, uint32_t duty);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+// ----------------------------------------------------------
+// Serial: вывод в stdout, ввод из очереди, заполняемой хост-кодом
+// ----------------------------------------------------------
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  size_t write(uint8_t c) override;
+  using Print::write;
+  int available();
+  int read();
+  void flush() { fflush(stdout); }
+  explicit operator bool() const { return true; }
+
+  // Хост: подать байты "с клавиатуры"
+  void inject(const char* text);
+  // Хост: заглушить вывод (для быстрых прогонов)
+  bool muted = false;
+};
+
+extern HardwareSerial Serial;
+
+// ----------------------------------------------------------
+// ESP: перезагрузка на хосте лишь отмечается флагом
+// ----------------------------------------------------------
+
+class EspClass {
+public:
+  void restart() { restartRequested = true; }
+  bool restartRequested = false;
+};
+
+extern EspClass ESP;
@@ -0,0 +1,66 @@
+#include "Preferences.h"
+
+#include <string.h>
+
+namespace {
+  std::map<std::string, std::vector<uint8_t>>& storage() {
+    static std::map<std::string, std::vector<uint8_t>> values;
+    return values;
+  }
+
+  uint32_t writes = 0;
+}
+
+bool Preferences::begin(const char* name, bool ro) {
+  space    = name;
+  readOnly = ro;
+  return true;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+  if (readOnly) {
+    return 0;
+  }
+  const uint8_t* bytes = static_cast<const uint8_t*>(value);
+  storage()[space + "/" + key].assign(bytes, bytes + len);
+  ++writes;
+  return len;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+  auto it = storage().find(space + "/" + key);
+  if (it == storage().end() || it->second.size() > maxLen) {
+    return 0;
+  }
+  memcpy(buf, it->second.data(), it->second.size());
+  return it->second.size();
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  auto it = storage().find(space + "/" + key);
+  return it == storage().end() ? 0 : it->second.size();
+}
+
+bool Preferences::isKey(const char* key) {
+  return storage().count(space + "/" + key) > 0;
+}
+
+bool Preferences::remove(const char* key) {
+  return storage().erase(space + "/" + key) > 0;
+}
+
+bool Preferences::clear() {
+  const std::string prefix = space + "/";
+  for (auto it = storage().begin(); it != storage().end();) {
+    if (it->first.compare(0, prefix.size(), prefix) == 0) {
+      it = storage().erase(it);
+    } else {
+      ++it;
+    }
+  }
+  return true;
+}
+
+uint32_t Preferences::writeCount() {
+  return writes;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+// ----------------------------------------------------------
+// Хост-версия Preferences (NVS): хранилище в памяти процесса,
+// общее для всех экземпляров (переживает "перезагрузку" на хосте)
+// ----------------------------------------------------------
+
+class Preferences {
+public:
+  bool begin(const char* name, bool readOnly = false);
+  void end() {}
+
+  size_t putBytes(const char* key, const void* value, size_t len);
+  size_t getBytes(const char* key, void* buf, size_t maxLen);
+  size_t getBytesLength(const char* key);
+
+  size_t putUInt(const char* key, uint32_t value) { return putBytes(key, &value, sizeof(value)); }
+  uint32_t getUInt(const char* key, uint32_t defaultValue = 0) {
+    uint32_t value = defaultValue;
+    getBytes(key, &value, sizeof(value));
+    return value;
+  }
+
+  bool isKey(const char* key);
+  bool remove(const char* key);
+  bool clear();
+
+  // Хост: число операций записи (для оценки износа)
+  static uint32_t writeCount();
+
+private:
+  std::string space;
+  bool readOnly = false;
+};
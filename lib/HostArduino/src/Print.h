@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Минимальный аналог класса Print из ядра Arduino
+
+class Print {
+public:
+  virtual ~Print() = default;
+  virtual size_t write(uint8_t c) = 0;
+
+  size_t write(const char* str) { return str ? write(reinterpret_cast<const uint8_t*>(str), strlen(str)) : 0; }
+  size_t write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+      n += write(*buffer++);
+    }
+    return n;
+  }
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+  size_t print(int v) { return printf("%d", v); }
+  size_t print(unsigned int v) { return printf("%u", v); }
+  size_t print(long v) { return printf("%ld", v); }
+  size_t print(unsigned long v) { return printf("%lu", v); }
+  size_t print(long long v) { return printf("%lld", v); }
+  size_t print(unsigned long long v) { return printf("%llu", v); }
+  size_t print(double v, int digits = 2) { return printf("%.*f", digits, v); }
+
+  size_t println() { return write('\n'); }
+  template <typename T>
+  size_t println(T value) { return print(value) + println(); }
+  size_t println(double v, int digits) { return print(v, digits) + println(); }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (len < 0) {
+      return 0;
+    }
+    return write(reinterpret_cast<const uint8_t*>(buffer),
+                 static_cast<size_t>(len) < sizeof(buffer) ? static_cast<size_t>(len) : sizeof(buffer) - 1);
+  }
+};
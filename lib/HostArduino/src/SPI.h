@@ -0,0 +1,3 @@
+#pragma once
+
+// Хост-версия: аппаратного SPI нет, файл нужен только для #include <SPI.h>
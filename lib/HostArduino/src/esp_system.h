@@ -0,0 +1,6 @@
+#pragma once
+
+#include <stdint.h>
+
+// Хост-версия аппаратного RNG: детерминированная последовательность
+uint32_t esp_random();
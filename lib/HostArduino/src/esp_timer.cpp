@@ -0,0 +1,91 @@
+#include "esp_timer.h"
+
+#include <vector>
+
+// ----------------------------------------------------------
+// Таймеры: список взведённых, срабатывание из VirtualClock::setUs()
+// ----------------------------------------------------------
+
+struct esp_timer {
+  esp_timer_cb_t callback;
+  void*          arg;
+  uint64_t       deadlineUs;
+  uint64_t       periodUs;
+  bool           armed;
+};
+
+namespace {
+  std::vector<esp_timer*> timers;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle) {
+  esp_timer* timer = new esp_timer{args->callback, args->arg, 0, 0, false};
+  timers.push_back(timer);
+  *handle = timer;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs) {
+  if (timer->armed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  timer->deadlineUs = VirtualClock::nowUs() + timeoutUs;
+  timer->periodUs   = 0;
+  timer->armed      = true;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs) {
+  if (timer->armed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  timer->deadlineUs = VirtualClock::nowUs() + periodUs;
+  timer->periodUs   = periodUs;
+  timer->armed      = true;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  if (!timer->armed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  timer->armed = false;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+  for (auto it = timers.begin(); it != timers.end(); ++it) {
+    if (*it == timer) {
+      timers.erase(it);
+      break;
+    }
+  }
+  delete timer;
+  return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer) {
+  return timer->armed;
+}
+
+bool HostTimers::takeDue(uint64_t limitUs, esp_timer_cb_t& callback, void*& arg, uint64_t& deadlineUs) {
+  esp_timer* due = nullptr;
+  for (esp_timer* timer : timers) {
+    if (timer->armed && timer->deadlineUs <= limitUs && (due == nullptr || timer->deadlineUs < due->deadlineUs)) {
+      due = timer;
+    }
+  }
+  if (due == nullptr) {
+    return false;
+  }
+
+  callback   = due->callback;
+  arg        = due->arg;
+  deadlineUs = due->deadlineUs;
+  if (due->periodUs > 0) {
+    due->deadlineUs += due->periodUs;
+  } else {
+    due->armed = false;
+  }
+  return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "virtual_clock.h"
+
+// ----------------------------------------------------------
+// Хост-версия esp_timer на виртуальных часах. Обратные вызовы
+// срабатывают, когда часы переходят через их срок (delay(),
+// сон планировщика), - с часами, выставленными ровно на срок.
+// ----------------------------------------------------------
+
+typedef int esp_err_t;
+#define ESP_OK                0
+#define ESP_ERR_INVALID_STATE 0x103
+
+typedef void (*esp_timer_cb_t)(void* arg);
+
+typedef enum { ESP_TIMER_TASK } esp_timer_dispatch_t;
+
+typedef struct {
+  esp_timer_cb_t       callback;
+  void*                arg;
+  esp_timer_dispatch_t dispatch_method;
+  const char*          name;
+  bool                 skip_unhandled_events;
+} esp_timer_create_args_t;
+
+struct esp_timer;
+typedef struct esp_timer* esp_timer_handle_t;
+
+inline int64_t esp_timer_get_time() {
+  return static_cast<int64_t>(VirtualClock::nowUs());
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+bool      esp_timer_is_active(esp_timer_handle_t timer);
+
+namespace HostTimers {
+  // Ближайший таймер со сроком не позже limitUs: снимает (или
+  // перевзводит периодический) и отдаёт его обработчик и срок
+  bool takeDue(uint64_t limitUs, esp_timer_cb_t& callback, void*& arg, uint64_t& deadlineUs);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+
+// ----------------------------------------------------------
+// Хост: управление "железом" из симуляции - уровни входов
+// (кнопка) и журнал звуковых вызовов.
+// ----------------------------------------------------------
+
+namespace HostPins {
+  // Выставить уровень на входе; вызывает обработчик attachInterrupt
+  void setInput(uint8_t pin, uint8_t level);
+  uint8_t outputLevel(uint8_t pin);
+
+  // Текущая частота пищалки (0 - тишина) и число начал звука
+  // (вызовы tone() и включения канала LEDC)
+  unsigned int lastToneFrequency();
+  uint32_t toneCount();
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+// ----------------------------------------------------------
+// Виртуальные часы хост-сборки. Всё время (millis, micros,
+// esp_timer_get_time) идёт отсюда; сдвигается только явно -
+// delay() или VirtualClock::advanceUs() из хост-кода - и только
+// вперёд. При сдвиге срабатывают таймеры esp_timer.
+// ----------------------------------------------------------
+
+namespace VirtualClock {
+  uint64_t nowUs();
+  void advanceUs(uint64_t us);
+  void setUs(uint64_t us);
+}
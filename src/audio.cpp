@@ -0,0 +1,208 @@
+#include <Arduino.h>
+#include <Adafruit_ST7735.h>
+#include <esp_timer.h>
+
+#include <atomic>
+
+#include "audio.h"
+#include "config.h"
+#include "melodies.h"
+#include "spsc_ring.h"
+
+// ----------------------------------------------------------
+// Очередь нот -> обратный вызов таймера -> LEDC
+// ----------------------------------------------------------
+
+namespace Audio {
+
+namespace {
+
+constexpr uint32_t TICK_MS  = Config::Sound::TICK_US / 1000;
+constexpr uint32_t MAX_DUTY = 1UL << (Config::Sound::LEDC_RESOLUTION - 1); // меандр 50%
+
+static_assert(Config::Sound::TICK_US % 1000 == 0, "Шаг таймера звука - целое число мс");
+
+// Элемент очереди: одиночная нота или ссылка на мелодию
+struct Item {
+  Note                    note;
+  const Melodies::Melody* melody;
+  uint8_t                 epoch; // stop() увеличивает эпоху - старые элементы отбрасываются
+};
+
+uint8_t outputPin = 0;
+
+SpscRing<Item, Config::Sound::QUEUE_SIZE> queue;
+std::atomic<uint8_t> epoch{0};
+std::atomic<bool>    idle{true};
+esp_timer_handle_t   tickTimer = nullptr;
+
+// Состояние воспроизведения: только в обратном вызове таймера
+Note                    current      = {};
+bool                    active       = false;
+uint32_t                elapsedMs    = 0;
+uint8_t                 playingEpoch = 0;
+const Melodies::Melody* melody       = nullptr;
+uint16_t                melodyIndex  = 0;
+uint32_t                writtenDuty  = 0;
+
+// arduino-esp32 3.x адресует LEDC по выводу, 2.x - по каналу
+void setFrequency(uint16_t frequency) {
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+  ledcChangeFrequency(outputPin, frequency, Config::Sound::LEDC_RESOLUTION);
+#else
+  ledcChangeFrequency(Config::Sound::LEDC_CHANNEL, frequency, Config::Sound::LEDC_RESOLUTION);
+#endif
+}
+
+void setDuty(uint32_t duty) {
+  if (duty == writtenDuty) {
+    return;
+  }
+  writtenDuty = duty;
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+  ledcWrite(outputPin, duty);
+#else
+  ledcWrite(Config::Sound::LEDC_CHANNEL, duty);
+#endif
+}
+
+Note melodyNote(uint16_t index) {
+  // Темп уже учтён при компиляции: здесь только распаковка
+  const uint16_t packed = melody->notes[index];
+  const uint16_t gate   = Melodies::durationMsOf(packed);
+  return {Melodies::frequencyOf(packed), gate,
+          static_cast<uint16_t>(gate + Config::Sound::NOTE_PAUSE_BETWEEN),
+          Config::Sound::MELODY_ATTACK_MS, Config::Sound::MELODY_RELEASE_MS};
+}
+
+// Следующая нота: продолжение мелодии или новый элемент очереди
+bool takeNext() {
+  if (melody != nullptr && melodyIndex < melody->count) {
+    current = melodyNote(melodyIndex++);
+    return true;
+  }
+  melody = nullptr;
+
+  const uint8_t now = epoch.load(std::memory_order_acquire);
+  Item item;
+  while (queue.pop(item)) {
+    if (item.epoch != now) {
+      continue;
+    }
+    playingEpoch = item.epoch;
+    if (item.melody != nullptr) {
+      if (item.melody->count == 0) {
+        continue;
+      }
+      melody      = item.melody;
+      melodyIndex = 0;
+      current     = melodyNote(melodyIndex++);
+    } else {
+      current = item.note;
+    }
+    return true;
+  }
+  return false;
+}
+
+// Скважность в момент elapsedMs: нарастание, полка, спад, тишина после gateMs
+uint32_t dutyAt(uint32_t elapsed) {
+  if (current.frequency == 0 || elapsed >= current.gateMs) {
+    return 0;
+  }
+  if (elapsed < current.attackMs) {
+    return MAX_DUTY * (elapsed + 1) / (current.attackMs + 1);
+  }
+  const uint32_t left = current.gateMs - elapsed;
+  if (left <= current.releaseMs) {
+    return MAX_DUTY * left / (current.releaseMs + 1);
+  }
+  return MAX_DUTY;
+}
+
+void kick() {
+  if (idle.exchange(false, std::memory_order_acq_rel)) {
+    esp_timer_start_periodic(tickTimer, Config::Sound::TICK_US);
+  }
+}
+
+void onTick(void*) {
+  if (active && (playingEpoch != epoch.load(std::memory_order_acquire) || elapsedMs >= current.durationMs)) {
+    active = false;
+    if (playingEpoch != epoch.load(std::memory_order_acquire)) {
+      melody = nullptr;
+    }
+  }
+
+  if (!active && takeNext()) {
+    active    = true;
+    elapsedMs = 0;
+    if (current.frequency > 0) {
+      setFrequency(current.frequency);
+    }
+  }
+
+  if (!active) {
+    // Играть нечего: тишина и остановка таймера. Если loop() успел
+    // поставить ноту между проверкой очереди и idle, перезапускаемся сами
+    setDuty(0);
+    esp_timer_stop(tickTimer);
+    idle.store(true, std::memory_order_release);
+    if (!queue.empty()) {
+      kick();
+    }
+    return;
+  }
+
+  setDuty(dutyAt(elapsedMs));
+  elapsedMs += TICK_MS;
+}
+
+} // namespace
+
+void begin(uint8_t pin) {
+  outputPin = pin;
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+  ledcAttachChannel(pin, 1000, Config::Sound::LEDC_RESOLUTION, Config::Sound::LEDC_CHANNEL);
+#else
+  ledcSetup(Config::Sound::LEDC_CHANNEL, 1000, Config::Sound::LEDC_RESOLUTION);
+  ledcAttachPin(pin, Config::Sound::LEDC_CHANNEL);
+#endif
+  writtenDuty = 1; // гарантированно записать ноль
+  setDuty(0);
+
+  if (tickTimer == nullptr) {
+    esp_timer_create_args_t args = {};
+    args.callback = onTick;
+    args.name     = "audio";
+    esp_timer_create(&args, &tickTimer);
+  }
+}
+
+bool play(const Note& note) {
+  if (!queue.push({note, nullptr, epoch.load(std::memory_order_relaxed)})) {
+    return false;
+  }
+  kick();
+  return true;
+}
+
+bool playMelody(const Melodies::Melody& melody) {
+  if (!queue.push({Note{}, &melody, epoch.load(std::memory_order_relaxed)})) {
+    return false;
+  }
+  kick();
+  return true;
+}
+
+void stop() {
+  epoch.fetch_add(1, std::memory_order_acq_rel);
+  // Таймер стоит, только если звука нет; иначе он сам увидит новую эпоху
+  kick();
+}
+
+bool busy() {
+  return !idle.load(std::memory_order_acquire);
+}
+
+} // namespace Audio
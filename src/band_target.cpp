@@ -0,0 +1,150 @@
+#include <Arduino.h>
+
+#include "band_target.h"
+
+// ----------------------------------------------------------
+// Полоса: запись пикселей в порядке линии
+// ----------------------------------------------------------
+
+namespace {
+
+inline uint16_t wireOrder(uint16_t color) {
+  return static_cast<uint16_t>((color >> 8) | (color << 8));
+}
+
+} // namespace
+
+BandTarget::BandTarget() : RenderTarget(WIDTH, HEIGHT) {}
+
+void BandTarget::beginBand(St7735Display& panel, uint8_t band) {
+  active = static_cast<uint8_t>((active + 1) % BUFFERS);
+  bandY  = static_cast<int16_t>(band * ROWS);
+  panel.waitQueued(fence[active]);
+}
+
+void BandTarget::sendBand(St7735Display& panel) {
+  panel.setAddrWindow(0, bandY, WIDTH, ROWS);
+  fence[active] = panel.queuePixels(pixels[active], static_cast<uint32_t>(WIDTH) * BUFFER_ROWS);
+}
+
+// Горизонтальный отрезок уже отсечённых координат внутри полосы
+void BandTarget::fillSpan(int16_t x, int16_t y, int16_t w, uint16_t wireColor) {
+  uint16_t* out = &pixels[active][(y - bandY) * WIDTH + x];
+  for (int16_t i = 0; i < w; ++i) {
+    out[i] = wireColor;
+  }
+}
+
+void BandTarget::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  writePixel(x, y, color);
+}
+
+void BandTarget::writePixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || x >= _width || y < bandY || y >= bandY + BUFFER_ROWS) {
+    return;
+  }
+  pixels[active][(y - bandY) * WIDTH + x] = wireOrder(color);
+}
+
+// Отсечение по ширине экрана и строкам полосы: всё, что выше и ниже, - не здесь
+void BandTarget::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  if (h < 0) {
+    y += h + 1;
+    h = -h;
+  }
+  if (x < 0) {
+    w += x;
+    x = 0;
+  }
+  if (y < bandY) {
+    h -= bandY - y;
+    y = bandY;
+  }
+  if (x + w > _width) {
+    w = _width - x;
+  }
+  if (y + h > bandY + BUFFER_ROWS) {
+    h = bandY + BUFFER_ROWS - y;
+  }
+  if (w <= 0 || h <= 0) {
+    return;
+  }
+
+  const uint16_t wire = wireOrder(color);
+  for (int16_t row = y; row < y + h; ++row) {
+    fillSpan(x, row, w, wire);
+  }
+}
+
+void BandTarget::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  writeFillRect(x, y, 1, h, color);
+}
+
+void BandTarget::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  writeFillRect(x, y, w, 1, color);
+}
+
+void BandTarget::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  DRAW_PROFILE_PRIMITIVE(FillRect);
+  writeFillRect(x, y, w, h, color);
+}
+
+void BandTarget::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  writeFillRect(x, y, 1, h, color);
+}
+
+void BandTarget::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  writeFillRect(x, y, w, 1, color);
+}
+
+// ----------------------------------------------------------
+// Потоковая запись окна (спрайты, картинки)
+// ----------------------------------------------------------
+
+void BandTarget::setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+  windowX   = x;
+  windowY   = y;
+  windowW   = w;
+  windowH   = h;
+  windowPos = 0;
+}
+
+// Окно идёт отрезками строк; строки вне полосы пропускаются целиком
+void BandTarget::pushPixels(const uint16_t* source, uint32_t count) {
+  const uint32_t total = static_cast<uint32_t>(windowW) * windowH;
+  while (count > 0 && windowPos < total) {
+    const uint16_t column = windowPos % windowW;
+    const uint16_t span   = static_cast<uint16_t>(min<uint32_t>(count, windowW - column));
+    const int16_t  x      = windowX + column;
+    const int16_t  y      = windowY + windowPos / windowW;
+    if (y >= bandY && y < bandY + BUFFER_ROWS) {
+      uint16_t* out = &pixels[active][(y - bandY) * WIDTH];
+      for (uint16_t i = 0; i < span && x + i < _width; ++i) {
+        out[x + i] = wireOrder(source[i]);
+      }
+    }
+    source    += span;
+    count     -= span;
+    windowPos += span;
+  }
+}
+
+void BandTarget::pushColor(uint16_t color, uint32_t count) {
+  const uint16_t wire  = wireOrder(color);
+  const uint32_t total = static_cast<uint32_t>(windowW) * windowH;
+  while (count > 0 && windowPos < total) {
+    const uint16_t column = windowPos % windowW;
+    const uint16_t span   = static_cast<uint16_t>(min<uint32_t>(count, windowW - column));
+    const int16_t  x      = windowX + column;
+    const int16_t  y      = windowY + windowPos / windowW;
+    if (y >= bandY && y < bandY + BUFFER_ROWS && x < _width) {
+      fillSpan(x, y, min<int16_t>(span, _width - x), wire);
+    }
+    count     -= span;
+    windowPos += span;
+  }
+}
@@ -0,0 +1,72 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+
+#include <atomic>
+
+#include "boot_timeline.h"
+
+// ----------------------------------------------------------
+// Отметки этапов и отчёт
+// ----------------------------------------------------------
+
+namespace BootTimeline {
+
+namespace {
+
+constexpr uint8_t COUNT = static_cast<uint8_t>(Stage::COUNT);
+
+const char* const NAMES[COUNT] = {
+  "setup", "serial", "audio", "scheduler", "button", "render task",
+  "panel ready", "nvs", "rng", "intro posted", "first frame", "ready"
+};
+
+// Пишут loop() и задача отрисовки; 0 - не отмечен
+std::atomic<uint32_t> marks[COUNT];
+
+} // namespace
+
+void mark(Stage stage) {
+  // Время от сброса не бывает нулевым: 0 остаётся признаком "нет отметки"
+  uint32_t now = static_cast<uint32_t>(esp_timer_get_time());
+  if (now == 0) {
+    now = 1;
+  }
+  uint32_t expected = 0;
+  marks[static_cast<uint8_t>(stage)].compare_exchange_strong(expected, now, std::memory_order_relaxed);
+}
+
+uint32_t atUs(Stage stage) {
+  return marks[static_cast<uint8_t>(stage)].load(std::memory_order_relaxed);
+}
+
+void report(Print& out) {
+  // Этапы задачи отрисовки идут вперемешку с этапами setup() - сортируем по времени
+  uint8_t order[COUNT];
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < COUNT; ++i) {
+    if (marks[i].load(std::memory_order_relaxed) == 0) {
+      continue;
+    }
+    uint8_t j = count++;
+    while (j > 0 && marks[order[j - 1]].load(std::memory_order_relaxed) > marks[i].load(std::memory_order_relaxed)) {
+      order[j] = order[j - 1];
+      --j;
+    }
+    order[j] = static_cast<uint8_t>(i);
+  }
+
+  out.println("Boot timeline (ms since reset):");
+  uint32_t previous = 0;
+  for (uint8_t k = 0; k < count; ++k) {
+    const uint32_t at = marks[order[k]].load(std::memory_order_relaxed);
+    out.printf("  %-13s %8.1f  +%.1f\n", NAMES[order[k]], at / 1000.0, (at - previous) / 1000.0);
+    previous = at;
+  }
+
+  const uint32_t firstFrame = atUs(Stage::FirstFrame);
+  if (firstFrame != 0) {
+    out.printf("Boot to first frame: %.1f ms\n", firstFrame / 1000.0);
+  }
+}
+
+} // namespace BootTimeline
@@ -0,0 +1,179 @@
+#include <Arduino.h>
+#include <Adafruit_ST7735.h>
+#include <esp_timer.h>
+
+#include "button_input.h"
+#include "config.h"
+#include "scheduler.h"
+#include "spsc_ring.h"
+
+// ----------------------------------------------------------
+// Фронты из ISR -> антидребезг -> жесты
+// ----------------------------------------------------------
+
+namespace ButtonInput {
+
+namespace {
+
+struct Edge {
+  uint64_t atUs;
+  uint8_t  level;
+};
+
+constexpr uint64_t DEBOUNCE_US     = Scheduler::msToUs(Config::Input::DEBOUNCE_MS);
+constexpr uint64_t LONG_PRESS_US   = Scheduler::msToUs(Config::Input::LONG_PRESS_MS);
+constexpr uint64_t DOUBLE_CLICK_US = Scheduler::msToUs(Config::Input::DOUBLE_CLICK_MS);
+
+uint8_t buttonPin = 0;
+
+SpscRing<Edge, Config::Input::EDGE_QUEUE_SIZE> edges;
+volatile uint32_t droppedEdges = 0;
+volatile bool     needResync   = false;
+
+// Распознанные события: пишет и читает loop(), хватает небольшой очереди
+SpscRing<Event, 8> events;
+
+// Антидребезг по переднему фронту: первый фронт после тишины принимается
+// сразу, следующие DEBOUNCE_MS - только запоминаются как сырой уровень
+uint8_t  rawLevel     = HIGH;
+uint8_t  stableLevel  = HIGH;
+uint64_t lastCommitUs = 0;
+
+// Жесты
+uint64_t pressStartUs  = 0;
+bool     longFired     = false;
+bool     clickPending  = false; // последнее отпускание было коротким кликом
+uint64_t lastReleaseUs = 0;
+
+LatencyStats stats = {};
+
+void emit(Gesture gesture, uint64_t edgeUs) {
+  events.push({gesture, edgeUs});
+}
+
+void commit(uint8_t level, uint64_t atUs) {
+  stableLevel  = level;
+  lastCommitUs = atUs;
+
+  if (level == LOW) {
+    if (clickPending && atUs - lastReleaseUs > DOUBLE_CLICK_US) {
+      clickPending = false;
+    }
+    pressStartUs = atUs;
+    longFired    = false;
+    return;
+  }
+
+  if (longFired) {
+    return;
+  }
+  // loop() мог опоздать: длительность считаем по отметкам фронтов
+  if (atUs - pressStartUs >= LONG_PRESS_US) {
+    longFired    = true;
+    clickPending = false;
+    emit(Gesture::LongPress, pressStartUs + LONG_PRESS_US);
+    return;
+  }
+  if (clickPending) {
+    clickPending = false;
+    emit(Gesture::DoubleClick, atUs);
+  } else {
+    clickPending  = true;
+    lastReleaseUs = atUs;
+    emit(Gesture::ShortPress, atUs);
+  }
+}
+
+// Окно дребезга закрылось, а сырой уровень отличается от принятого:
+// контакт успокоился в другом положении
+void settle(uint64_t nowUs) {
+  if (rawLevel != stableLevel && nowUs - lastCommitUs >= DEBOUNCE_US) {
+    commit(rawLevel, lastCommitUs + DEBOUNCE_US);
+  }
+}
+
+void IRAM_ATTR onEdge() {
+  const Edge edge = {static_cast<uint64_t>(esp_timer_get_time()),
+                     static_cast<uint8_t>(digitalRead(buttonPin))};
+  if (!edges.push(edge)) {
+    droppedEdges = droppedEdges + 1;
+    needResync   = true;
+  }
+  Scheduler::wakeFromIsr();
+}
+
+} // namespace
+
+void begin(uint8_t pin) {
+  buttonPin = pin;
+  pinMode(pin, INPUT_PULLUP);
+  rawLevel     = static_cast<uint8_t>(digitalRead(pin));
+  stableLevel  = rawLevel;
+  lastCommitUs = Scheduler::nowUs();
+  attachInterrupt(digitalPinToInterrupt(pin), onEdge, CHANGE);
+}
+
+void poll(uint64_t nowUs) {
+  Edge edge;
+  while (edges.pop(edge)) {
+    // Окно дребезга могло закрыться ещё до этого фронта
+    settle(edge.atUs);
+    rawLevel = edge.level;
+    if (rawLevel != stableLevel && edge.atUs - lastCommitUs >= DEBOUNCE_US) {
+      commit(rawLevel, edge.atUs);
+    }
+  }
+
+  // Кольцо переполнялось: часть фронтов потеряна, берём текущий уровень
+  if (needResync) {
+    needResync = false;
+    rawLevel = static_cast<uint8_t>(digitalRead(buttonPin));
+  }
+
+  settle(nowUs);
+
+  if (stableLevel == LOW && !longFired && nowUs - pressStartUs >= LONG_PRESS_US) {
+    longFired    = true;
+    clickPending = false;
+    emit(Gesture::LongPress, pressStartUs + LONG_PRESS_US);
+  }
+}
+
+bool nextEvent(Event& event) {
+  return events.pop(event);
+}
+
+uint64_t nextDeadlineUs() {
+  if (rawLevel != stableLevel) {
+    return lastCommitUs + DEBOUNCE_US;
+  }
+  if (stableLevel == LOW && !longFired) {
+    return pressStartUs + LONG_PRESS_US;
+  }
+  return 0;
+}
+
+void recordLatency(const Event& event, uint64_t handledUs) {
+  const uint32_t latency = static_cast<uint32_t>(handledUs - event.edgeUs);
+  ++stats.events;
+  stats.totalUs += latency;
+  if (latency > stats.maxUs) {
+    stats.maxUs = latency;
+  }
+}
+
+const LatencyStats& latencyStats() {
+  stats.droppedEdges = droppedEdges;
+  return stats;
+}
+
+const char* gestureName(Gesture gesture) {
+  switch (gesture) {
+    case Gesture::ShortPress:  return "short";
+    case Gesture::LongPress:   return "long";
+    case Gesture::DoubleClick: return "double";
+  }
+  return "?";
+}
+
+} // namespace ButtonInput
@@ -0,0 +1,157 @@
+#include <Arduino.h>
+#include <esp_system.h>
+
+#include "dice_rng.h"
+
+// ----------------------------------------------------------
+// xoshiro128** + пачки бросков по Лемиру
+// ----------------------------------------------------------
+
+namespace DiceRng {
+
+namespace {
+
+// Пачка не больше 2^24 исходов: доля повторов по Лемиру < 1/256
+constexpr uint32_t BATCH_LIMIT = 1UL << 24;
+
+// Многочлен прыжка на 2^64 шагов (из эталонной реализации xoshiro128**)
+constexpr uint32_t JUMP[4] = {0x8764000Bu, 0xF542D2D3u, 0x6FA035C3u, 0x77F2DB5Bu};
+
+// Генератор loop()
+Generator shared;
+
+inline uint32_t rotl(uint32_t x, int k) {
+  return (x << k) | (x >> (32 - k));
+}
+
+// splitmix64: растягивает seed на всё состояние, нулевым оно не будет
+uint64_t splitmix64(uint64_t& x) {
+  uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+} // namespace
+
+void Generator::refill(uint8_t faces) {
+  uint32_t bound = faces;
+  uint8_t  count = 1;
+  while (static_cast<uint64_t>(bound) * faces <= BATCH_LIMIT) {
+    bound *= faces;
+    ++count;
+  }
+  batchValue = below(bound);
+  batchLeft  = count;
+  batchFaces = faces;
+}
+
+void Generator::seedFromHardware() {
+  seed((static_cast<uint64_t>(esp_random()) << 32) | esp_random());
+}
+
+void Generator::seed(uint64_t value) {
+  for (int i = 0; i < 4; i += 2) {
+    const uint64_t word = splitmix64(value);
+    state[i]     = static_cast<uint32_t>(word);
+    state[i + 1] = static_cast<uint32_t>(word >> 32);
+  }
+  batchLeft  = 0;
+  batchFaces = 0;
+}
+
+void Generator::jump() {
+  uint32_t jumped[4] = {};
+  for (uint32_t word : JUMP) {
+    for (int bit = 0; bit < 32; ++bit) {
+      if (word & (1u << bit)) {
+        for (int i = 0; i < 4; ++i) {
+          jumped[i] ^= state[i];
+        }
+      }
+      next();
+    }
+  }
+  for (int i = 0; i < 4; ++i) {
+    state[i] = jumped[i];
+  }
+  batchLeft  = 0;
+  batchFaces = 0;
+}
+
+uint32_t Generator::next() {
+  const uint32_t result = rotl(state[1] * 5, 7) * 9;
+  const uint32_t t = state[1] << 9;
+
+  state[2] ^= state[0];
+  state[3] ^= state[1];
+  state[1] ^= state[2];
+  state[0] ^= state[3];
+  state[2] ^= t;
+  state[3] = rotl(state[3], 11);
+
+  return result;
+}
+
+uint32_t Generator::below(uint32_t range) {
+  uint64_t m = static_cast<uint64_t>(next()) * range;
+  uint32_t low = static_cast<uint32_t>(m);
+  if (low < range) {
+    // Порог (2^32 - range) mod range считается только в редком случае
+    const uint32_t threshold = static_cast<uint32_t>(-range) % range;
+    while (low < threshold) {
+      m   = static_cast<uint64_t>(next()) * range;
+      low = static_cast<uint32_t>(m);
+    }
+  }
+  return static_cast<uint32_t>(m >> 32);
+}
+
+uint8_t Generator::roll(uint8_t faces) {
+  if (faces < 2) {
+    return 1;
+  }
+  if (batchLeft == 0 || batchFaces != faces) {
+    refill(faces);
+  }
+  const uint8_t value = static_cast<uint8_t>(batchValue % faces);
+  batchValue /= faces;
+  --batchLeft;
+  return value + 1;
+}
+
+void Generator::fill(uint8_t* out, uint16_t count, uint8_t faces) {
+  for (uint16_t i = 0; i < count; ++i) {
+    out[i] = roll(faces);
+  }
+}
+
+// ----------------------------------------------------------
+// Общий генератор loop()
+// ----------------------------------------------------------
+
+void seedFromHardware() {
+  shared.seedFromHardware();
+}
+
+void seed(uint64_t value) {
+  shared.seed(value);
+}
+
+uint32_t next() {
+  return shared.next();
+}
+
+uint32_t below(uint32_t range) {
+  return shared.below(range);
+}
+
+uint8_t roll(uint8_t faces) {
+  return shared.roll(faces);
+}
+
+void fill(uint8_t* out, uint16_t count, uint8_t faces) {
+  shared.fill(out, count, faces);
+}
+
+} // namespace DiceRng
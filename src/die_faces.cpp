@@ -0,0 +1,93 @@
+#include <Arduino.h>
+
+#include "die_faces.h"
+
+// ----------------------------------------------------------
+// Точки или число - выбор при компиляции
+// ----------------------------------------------------------
+
+namespace DieFaces {
+
+namespace {
+
+// Основной шаблон - числа; буферы и таблицы цифр появляются, только
+// если он используется (кость больше d9)
+template <bool Pips>
+struct Faces {
+  static constexpr DigitSet DIGITS = buildDigits();
+
+  // Одна строка шрифта (NUMERAL_SCALE строк пикселей) за одну передачу
+  static constexpr uint32_t BLOCK_PIXELS = static_cast<uint32_t>(NUMERAL_W) * NUMERAL_SCALE;
+  static uint16_t blockBuffer[BLOCK_PIXELS];
+
+  // Пиксель окна числа: однозначное - по центру окна, двузначное - по ячейке на цифру
+  static bool pixel(uint8_t value, uint16_t x, uint16_t y) {
+    if (value < 10) {
+      const int16_t column = static_cast<int16_t>(x) - NUMERAL_CELL_W / 2;
+      return value > 0 && column >= 0 && column < NUMERAL_CELL_W && DIGITS.digits[value].get(column, y);
+    }
+    if (x < NUMERAL_CELL_W) {
+      return DIGITS.digits[value / 10].get(x, y);
+    }
+    return DIGITS.digits[value % 10].get(x - NUMERAL_CELL_W, y);
+  }
+
+  // Окно числа всегда одного размера: прошлое число затирается целиком
+  static void draw(RenderTarget& target, int16_t x, int16_t y, uint8_t value, uint16_t color, uint16_t background) {
+    DRAW_PROFILE_PRIMITIVE(Glyph);
+    target.setAddrWindow(x + NUMERAL_OFFSET_X, y + NUMERAL_OFFSET_Y, NUMERAL_W, NUMERAL_H);
+
+    uint32_t filled = 0;
+    for (uint16_t row = 0; row < NUMERAL_H; ++row) {
+      for (uint16_t column = 0; column < NUMERAL_W; ++column) {
+        blockBuffer[filled++] = pixel(value, column, row) ? color : background;
+      }
+      if (filled == BLOCK_PIXELS) {
+        target.pushPixels(blockBuffer, filled);
+        filled = 0;
+      }
+    }
+  }
+
+  static void update(RenderTarget& target, int16_t x, int16_t y, uint8_t oldValue, uint8_t value,
+                     uint16_t color, uint16_t background) {
+    if (value != oldValue) {
+      draw(target, x, y, value, color, background);
+    }
+  }
+};
+
+template <bool Pips>
+uint16_t Faces<Pips>::blockBuffer[Faces<Pips>::BLOCK_PIXELS];
+
+// Точки: спрайты граней и пошаговое обновление из PipSprites
+template <>
+struct Faces<true> {
+  static void draw(RenderTarget& target, int16_t x, int16_t y, uint8_t value, uint16_t pipColor, uint16_t fillColor) {
+    PipSprites::drawFace(target, x, y, value, pipColor, fillColor);
+  }
+
+  static void update(RenderTarget& target, int16_t x, int16_t y, uint8_t oldValue, uint8_t value,
+                     uint16_t pipColor, uint16_t fillColor) {
+    // Общие для двух граней точки не трогаем: только стереть лишние и дорисовать новые
+    PipSprites::updateFace(target, x, y, oldValue, value, pipColor, fillColor);
+  }
+};
+
+using Selected = Faces<USE_PIPS>;
+
+} // namespace
+
+void draw(RenderTarget& target, int16_t x, int16_t y, uint8_t value, uint16_t pipColor, uint16_t fillColor) {
+  if (value == 0) {
+    return;
+  }
+  Selected::draw(target, x, y, value, pipColor, fillColor);
+}
+
+void update(RenderTarget& target, int16_t x, int16_t y, uint8_t oldValue, uint8_t value,
+            uint16_t pipColor, uint16_t fillColor) {
+  Selected::update(target, x, y, oldValue, value, pipColor, fillColor);
+}
+
+} // namespace DieFaces
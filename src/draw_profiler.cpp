@@ -0,0 +1,195 @@
+#include "draw_profiler.h"
+
+#if defined(DRAW_PROFILER)
+
+#include <Adafruit_ST7735.h>
+#include <string.h>
+
+#include <atomic>
+
+// ----------------------------------------------------------
+// Таблица счётчиков: обработчик x примитив, плюс итог по состояниям
+// ----------------------------------------------------------
+
+namespace DrawProfiler {
+
+namespace {
+
+constexpr uint8_t HANDLER_COUNT   = static_cast<uint8_t>(Handler::COUNT);
+constexpr uint8_t PRIMITIVE_COUNT = static_cast<uint8_t>(Primitive::COUNT);
+constexpr uint8_t MAX_STATES      = 8;
+
+const char* const HANDLER_NAMES[HANDLER_COUNT] = {
+  "other", "showIntro", "startDiceRoll", "handleDiceAnimation", "drawTimer", "drawAlert"
+};
+
+const char* const PRIMITIVE_NAMES[PRIMITIVE_COUNT] = {
+  "other", "fillScreen", "fillRect", "roundRect", "triangle", "circle",
+  "text", "pipSprite", "timerGlyph", "command", "frameFlush"
+};
+
+Counters table[HANDLER_COUNT][PRIMITIVE_COUNT];
+uint32_t stateBytes[MAX_STATES];
+
+Handler   currentHandler   = Handler::Other;
+Handler   frameOwner       = Handler::Other;
+Primitive currentPrimitive = Primitive::Other;
+uint8_t   primitiveDepth   = 0;
+std::atomic<uint8_t> currentState{0}; // пишет loop(), читает задача отрисовки
+
+Counters& current() {
+  return table[static_cast<uint8_t>(currentHandler)][static_cast<uint8_t>(currentPrimitive)];
+}
+
+void countBytes(uint32_t Counters::*field, uint32_t bytes) {
+  current().*field += bytes;
+  const uint8_t state = currentState.load(std::memory_order_relaxed);
+  if (state < MAX_STATES) {
+    stateBytes[state] += bytes;
+  }
+}
+
+} // namespace
+
+// ----------------------------------------------------------
+// Области действия
+// ----------------------------------------------------------
+
+HandlerScope::HandlerScope(Handler handler) : previous(currentHandler) {
+  currentHandler = handler;
+}
+
+HandlerScope::~HandlerScope() {
+  currentHandler = previous;
+}
+
+PrimitiveScope::PrimitiveScope(Primitive primitive) : outermost(primitiveDepth == 0), startUs(0) {
+  ++primitiveDepth;
+  if (outermost) {
+    currentPrimitive = primitive;
+    if (currentHandler != Handler::Other) {
+      frameOwner = currentHandler;
+    }
+    ++current().calls;
+    startUs = micros();
+  }
+}
+
+PrimitiveScope::~PrimitiveScope() {
+  --primitiveDepth;
+  if (outermost) {
+    current().micros += micros() - startUs;
+    currentPrimitive = Primitive::Other;
+  }
+}
+
+FrameScope::FrameScope() : handler(frameOwner), primitive(Primitive::Flush) {
+  frameOwner = Handler::Other;
+}
+
+// ----------------------------------------------------------
+// Шина-обёртка
+// ----------------------------------------------------------
+
+void ProfilingBus::begin() {
+  target.begin();
+}
+
+void ProfilingBus::writeCommand(uint8_t cmd) {
+  if (cmd == ST77XX_CASET) {
+    ++current().windows;
+  }
+  countBytes(&Counters::commandBytes, 1);
+  target.writeCommand(cmd);
+}
+
+void ProfilingBus::writeData(const uint8_t* data, size_t len) {
+  countBytes(&Counters::paramBytes, len);
+  target.writeData(data, len);
+}
+
+void ProfilingBus::writeColor(uint16_t color, uint32_t count) {
+  countBytes(&Counters::pixelBytes, count * 2);
+  target.writeColor(color, count);
+}
+
+void ProfilingBus::writePixels(const uint16_t* pixels, uint32_t count) {
+  countBytes(&Counters::pixelBytes, count * 2);
+  target.writePixels(pixels, count);
+}
+
+uint32_t ProfilingBus::queuePixels(const uint16_t* wirePixels, uint32_t count) {
+  countBytes(&Counters::pixelBytes, count * 2);
+  return target.queuePixels(wirePixels, count);
+}
+
+void ProfilingBus::waitQueued(uint32_t token) {
+  target.waitQueued(token);
+}
+
+void ProfilingBus::flush() {
+  target.flush();
+}
+
+TftBus& wrapBus(TftBus& bus) {
+  static ProfilingBus profilingBus(bus);
+  return profilingBus;
+}
+
+void setState(uint8_t state) {
+  currentState.store(state, std::memory_order_relaxed);
+}
+
+// ----------------------------------------------------------
+// Отчёт
+// ----------------------------------------------------------
+
+void reset() {
+  memset(table, 0, sizeof(table));
+  memset(stateBytes, 0, sizeof(stateBytes));
+}
+
+const Counters& counters(Handler handler, Primitive primitive) {
+  return table[static_cast<uint8_t>(handler)][static_cast<uint8_t>(primitive)];
+}
+
+void report(Print& out, const char* const* stateNames, uint8_t stateCount) {
+  out.println("--- draw profile ---");
+  out.printf("%-20s %-11s %7s %7s %7s %7s %9s %9s\n",
+             "handler", "primitive", "calls", "windows", "cmd", "param", "pixel_B", "cpu_us");
+
+  for (uint8_t h = 0; h < HANDLER_COUNT; ++h) {
+    for (uint8_t p = 0; p < PRIMITIVE_COUNT; ++p) {
+      const Counters& c = table[h][p];
+      if (c.calls == 0 && c.commandBytes == 0 && c.pixelBytes == 0) {
+        continue;
+      }
+      out.printf("%-20s %-11s %7lu %7lu %7lu %7lu %9lu %9lu\n",
+                 HANDLER_NAMES[h], PRIMITIVE_NAMES[p],
+                 static_cast<unsigned long>(c.calls), static_cast<unsigned long>(c.windows),
+                 static_cast<unsigned long>(c.commandBytes), static_cast<unsigned long>(c.paramBytes),
+                 static_cast<unsigned long>(c.pixelBytes), static_cast<unsigned long>(c.micros));
+    }
+  }
+
+  out.println("bus bytes by state:");
+  for (uint8_t s = 0; s < stateCount && s < MAX_STATES; ++s) {
+    out.printf("  %-14s %lu\n", stateNames[s], static_cast<unsigned long>(stateBytes[s]));
+  }
+}
+
+void command(char c, const char* const* stateNames, uint8_t stateCount) {
+  switch (c) {
+    case 'p':
+      report(Serial, stateNames, stateCount);
+      break;
+    case 'r':
+      reset();
+      Serial.println("draw profile reset");
+      break;
+  }
+}
+
+} // namespace DrawProfiler
+
+#endif // defined(DRAW_PROFILER)
@@ -0,0 +1,219 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+
+#include <atomic>
+
+#include "button_input.h"
+#include "event_log.h"
+#include "spsc_ring.h"
+
+// ----------------------------------------------------------
+// Кольцо записей, задача вывода и декодер хоста
+// ----------------------------------------------------------
+
+namespace EventLog {
+
+namespace {
+
+SpscRing<Record, Config::Log::RING_SIZE> ring;
+std::atomic<uint32_t> dropped{0};
+uint32_t              droppedReported = 0; // сторона задачи вывода
+std::atomic<bool>     busy{false};
+
+void putU32(uint8_t* out, uint32_t value) {
+  out[0] = static_cast<uint8_t>(value);
+  out[1] = static_cast<uint8_t>(value >> 8);
+  out[2] = static_cast<uint8_t>(value >> 16);
+  out[3] = static_cast<uint8_t>(value >> 24);
+}
+
+uint8_t checksum(const uint8_t* bytes, size_t count) {
+  uint8_t sum = 0;
+  for (size_t i = 0; i < count; ++i) {
+    sum = static_cast<uint8_t>(sum + bytes[i]);
+  }
+  return static_cast<uint8_t>(~sum);
+}
+
+#if !defined(ESP32)
+Decoder hostDecoder;
+#endif
+
+void emit(const Record& record) {
+  uint8_t wire[MAX_WIRE_BYTES];
+  const size_t length = encode(record, wire);
+#if defined(ESP32)
+  Serial.write(wire, length);
+#else
+  // Хост: тот же поток байт, но сразу через декодер - в stdout текст
+  for (size_t i = 0; i < length; ++i) {
+    hostDecoder.feed(wire[i], Serial);
+  }
+#endif
+}
+
+// Всё из кольца - в Serial (здесь можно ждать UART); потери - отдельной записью
+void drain() {
+  busy.store(true, std::memory_order_release);
+  Record record;
+  while (ring.pop(record)) {
+    emit(record);
+  }
+
+  const uint32_t lost = dropped.load(std::memory_order_relaxed);
+  if (lost != droppedReported) {
+    Record notice{static_cast<uint32_t>(esp_timer_get_time()), Event::LogDropped, 1, {}};
+    notice.args[0] = static_cast<int32_t>(lost - droppedReported);
+    droppedReported = lost;
+    emit(notice);
+  }
+  busy.store(false, std::memory_order_release);
+}
+
+#if defined(ESP32)
+void drainTaskMain(void*) {
+  for (;;) {
+    drain();
+    vTaskDelay(pdMS_TO_TICKS(Config::Log::DRAIN_PERIOD_MS));
+  }
+}
+#endif
+
+} // namespace
+
+size_t encode(const Record& record, uint8_t* out) {
+  const uint8_t argc = record.argc < MAX_ARGS ? record.argc : MAX_ARGS;
+  out[0] = SYNC;
+  out[1] = static_cast<uint8_t>(record.event);
+  out[2] = argc;
+  putU32(&out[3], record.timeUs);
+  size_t length = HEADER_BYTES;
+  for (uint8_t i = 0; i < argc; ++i) {
+    putU32(&out[length], static_cast<uint32_t>(record.args[i]));
+    length += 4;
+  }
+  out[length] = checksum(&out[1], length - 1);
+  return length + 1;
+}
+
+void begin() {
+#if defined(ESP32)
+  xTaskCreatePinnedToCore(drainTaskMain, "log", Config::Log::TASK_STACK, nullptr,
+                          Config::Log::TASK_PRIORITY, nullptr, Config::Log::TASK_CORE);
+#endif
+}
+
+void write(Event event, const int32_t* args, uint8_t argc) {
+  Record record{static_cast<uint32_t>(esp_timer_get_time()), event, argc, {}};
+  for (uint8_t i = 0; i < argc && i < MAX_ARGS; ++i) {
+    record.args[i] = args[i];
+  }
+  if (!ring.push(record)) {
+    dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+#if !defined(ESP32)
+  // Хост: задачи нет - сразу через линию и декодер, вывод остаётся детерминированным
+  drain();
+#endif
+}
+
+void flush() {
+#if defined(ESP32)
+  while (!ring.empty() || busy.load(std::memory_order_acquire)) {
+    delay(1);
+  }
+#endif
+  Serial.flush();
+}
+
+uint32_t droppedCount() {
+  return dropped.load(std::memory_order_relaxed);
+}
+
+#if !defined(ESP32)
+
+// ----------------------------------------------------------
+// Декодер (только хост)
+// ----------------------------------------------------------
+
+void format(const Record& record, Print& out) {
+  out.printf("[%9.3f] ", record.timeUs / 1000.0);
+  if (static_cast<uint8_t>(record.event) >= EVENT_COUNT) {
+    out.printf("<unknown event %u>\n", static_cast<unsigned>(record.event));
+    return;
+  }
+
+  uint8_t arg = 0;
+  for (const char* c = FORMATS[static_cast<uint8_t>(record.event)]; *c != '\0'; ++c) {
+    if (*c != '%' || c[1] == '\0') {
+      out.print(*c);
+      continue;
+    }
+    const int32_t value = arg < record.argc ? record.args[arg] : 0;
+    ++arg;
+    switch (*++c) {
+      case 'd':
+        out.printf("%ld", static_cast<long>(value));
+        break;
+      case 'G':
+        out.print(ButtonInput::gestureName(static_cast<ButtonInput::Gesture>(value)));
+        break;
+      default:
+        out.printf("%lu", static_cast<unsigned long>(static_cast<uint32_t>(value)));
+        break;
+    }
+  }
+  out.println();
+}
+
+namespace {
+
+uint32_t getU32(const uint8_t* in) {
+  return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+         (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+} // namespace
+
+void Decoder::feed(uint8_t byte, Print& out) {
+  if (filled == 0) {
+    if (byte == SYNC) {
+      frame[filled++] = byte;
+      expected = HEADER_BYTES;
+    } else {
+      out.write(byte);
+    }
+    return;
+  }
+
+  frame[filled++] = byte;
+  if (filled == 3) {
+    // Известно число аргументов - известна длина записи
+    if (frame[2] > MAX_ARGS) {
+      ++corrupt;
+      filled = 0;
+      return;
+    }
+    expected = HEADER_BYTES + 4u * frame[2] + 1;
+  }
+  if (filled < expected || filled < 3) {
+    return;
+  }
+
+  filled = 0;
+  if (checksum(&frame[1], expected - 2) != frame[expected - 1]) {
+    ++corrupt;
+    out.println("<corrupt log record>");
+    return;
+  }
+  Record record{getU32(&frame[3]), static_cast<Event>(frame[1]), frame[2], {}};
+  for (uint8_t i = 0; i < record.argc; ++i) {
+    record.args[i] = static_cast<int32_t>(getU32(&frame[HEADER_BYTES + 4 * i]));
+  }
+  ++records;
+  format(record, out);
+}
+
+#endif // !defined(ESP32)
+
+} // namespace EventLog
@@ -0,0 +1,319 @@
+#if !defined(ESP32)
+
+#include <Arduino.h>
+#include <Adafruit_ST7735.h>
+#include <esp_system.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "config.h"
+#include "dice_rng.h"
+#include "fairness_bench.h"
+
+// Цвет суммы - та же функция, что у экрана результата (main.cpp)
+uint16_t getColorForSum(int sum);
+
+// ----------------------------------------------------------
+// Броски по потокам и слияние гистограмм
+// ----------------------------------------------------------
+
+namespace FairnessBench {
+
+namespace {
+
+constexpr uint8_t COUNT   = Config::Dice::COUNT;
+constexpr uint8_t FACES   = Config::Dice::FACES;
+constexpr int     MIN_SUM = COUNT;
+constexpr int     MAX_SUM = COUNT * FACES;
+
+// Порог провала: p-значение хи-квадрат и |z| корреляции
+constexpr double MIN_P = 1e-6;
+constexpr double MAX_Z = 5.0;
+
+// Шкала цветов от среднего к краям (порядок как в getColorForSum)
+constexpr uint16_t LEVEL_COLORS[] = {
+  Config::Colors::DiceSum::SUM_7,    Config::Colors::DiceSum::SUM_6_8,
+  Config::Colors::DiceSum::SUM_5_9,  Config::Colors::DiceSum::SUM_4_10,
+  Config::Colors::DiceSum::SUM_3_11, Config::Colors::DiceSum::SUM_2_12
+};
+constexpr uint8_t LEVEL_COUNT = sizeof(LEVEL_COLORS) / sizeof(LEVEL_COLORS[0]);
+
+struct Shard {
+  uint64_t rolls = 0;
+  uint64_t faces[FACES + 1] = {};
+  uint64_t sums[MAX_SUM + 1] = {};
+  uint64_t pairs[FACES][FACES] = {}; // первый кубик соседних бросков
+
+  // Соседние суммы x(i), x(i+1) внутри потока
+  uint64_t lagPairs = 0;
+  uint64_t sumX = 0, sumY = 0, sumXX = 0, sumYY = 0, sumXY = 0;
+};
+
+void rollShard(DiceRng::Generator generator, uint64_t rolls, Shard& out) {
+  Shard shard;
+  uint8_t dice[COUNT];
+  uint8_t  previousFirst = 0;
+  uint32_t previousSum   = 0;
+  for (uint64_t n = 0; n < rolls; ++n) {
+    generator.fill(dice, COUNT, FACES);
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < COUNT; ++i) {
+      ++shard.faces[dice[i]];
+      sum += dice[i];
+    }
+    ++shard.sums[sum];
+    if (n > 0) {
+      ++shard.pairs[previousFirst - 1][dice[0] - 1];
+      ++shard.lagPairs;
+      shard.sumX  += previousSum;
+      shard.sumY  += sum;
+      shard.sumXX += static_cast<uint64_t>(previousSum) * previousSum;
+      shard.sumYY += static_cast<uint64_t>(sum) * sum;
+      shard.sumXY += static_cast<uint64_t>(previousSum) * sum;
+    }
+    previousFirst = dice[0];
+    previousSum   = sum;
+  }
+  shard.rolls = rolls;
+  out = shard;
+}
+
+void merge(Shard& total, const Shard& shard) {
+  total.rolls += shard.rolls;
+  for (int i = 0; i <= FACES; ++i) {
+    total.faces[i] += shard.faces[i];
+  }
+  for (int i = 0; i <= MAX_SUM; ++i) {
+    total.sums[i] += shard.sums[i];
+  }
+  for (int a = 0; a < FACES; ++a) {
+    for (int b = 0; b < FACES; ++b) {
+      total.pairs[a][b] += shard.pairs[a][b];
+    }
+  }
+  total.lagPairs += shard.lagPairs;
+  total.sumX  += shard.sumX;
+  total.sumY  += shard.sumY;
+  total.sumXX += shard.sumXX;
+  total.sumYY += shard.sumYY;
+  total.sumXY += shard.sumXY;
+}
+
+// ----------------------------------------------------------
+// Статистика
+// ----------------------------------------------------------
+
+// Точное распределение суммы: число исходов на каждую сумму из FACES^COUNT
+std::vector<double> sumWays() {
+  std::vector<double> ways(MAX_SUM + 1, 0.0);
+  ways[0] = 1.0;
+  for (uint8_t die = 0; die < COUNT; ++die) {
+    std::vector<double> next(MAX_SUM + 1, 0.0);
+    for (int s = 0; s <= MAX_SUM; ++s) {
+      if (ways[s] == 0.0) {
+        continue;
+      }
+      for (int f = 1; f <= FACES && s + f <= MAX_SUM; ++f) {
+        next[s + f] += ways[s];
+      }
+    }
+    ways.swap(next);
+  }
+  return ways;
+}
+
+struct ChiSquare {
+  double   value;
+  unsigned dof;
+  double   p;
+};
+
+// Хвост хи-квадрат по Уилсону-Хилферти (нормальное приближение)
+double upperTail(double chi2, unsigned dof) {
+  if (dof == 0) {
+    return 1.0;
+  }
+  const double k = dof;
+  const double z = (cbrt(chi2 / k) - (1.0 - 2.0 / (9.0 * k))) / sqrt(2.0 / (9.0 * k));
+  return 0.5 * erfc(z / sqrt(2.0));
+}
+
+// Соседние ячейки с ожиданием меньше 5 объединяются - иначе хвосты
+// редких сумм (5d20) ломают приближение
+ChiSquare chiSquare(const std::vector<double>& observed, const std::vector<double>& expected) {
+  double   chi2  = 0.0;
+  unsigned cells = 0;
+  double   o = 0.0, e = 0.0;
+  for (size_t i = 0; i < observed.size(); ++i) {
+    o += observed[i];
+    e += expected[i];
+    if (e >= 5.0 || i + 1 == observed.size()) {
+      if (e > 0.0) {
+        chi2 += (o - e) * (o - e) / e;
+        ++cells;
+      }
+      o = e = 0.0;
+    }
+  }
+  const unsigned dof = cells > 1 ? cells - 1 : 0;
+  return {chi2, dof, upperTail(chi2, dof)};
+}
+
+bool reportChi(const char* name, const ChiSquare& chi) {
+  const bool ok = chi.p >= MIN_P;
+  printf("  %-22s chi2 %12.3f  dof %4u  p %.4f  %s\n", name, chi.value, chi.dof, chi.p, ok ? "ok" : "FAIL");
+  return ok;
+}
+
+int levelOf(uint16_t color) {
+  for (uint8_t i = 0; i < LEVEL_COUNT; ++i) {
+    if (LEVEL_COLORS[i] == color) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Шкала цветов: каждая сумма окрашена, зеркальные суммы - одним цветом,
+// уровень не убывает от среднего к краям
+bool checkColorScale() {
+  bool ok = true;
+  int  previousLevel = 0;
+  const int mirror = MIN_SUM + MAX_SUM;
+  for (int s = (mirror + 1) / 2; s <= MAX_SUM; ++s) {
+    const uint16_t color = getColorForSum(s);
+    const int      level = levelOf(color);
+    if (level < 0 || getColorForSum(mirror - s) != color || level < previousLevel) {
+      printf("  colour scale: sum %d -> 0x%04X (mirror %d -> 0x%04X) FAIL\n",
+             s, color, mirror - s, getColorForSum(mirror - s));
+      ok = false;
+    }
+    previousLevel = level;
+  }
+  if (ok) {
+    printf("  colour scale           symmetric, monotone, all %d sums coloured  ok\n", MAX_SUM - MIN_SUM + 1);
+  }
+  return ok;
+}
+
+} // namespace
+
+// ----------------------------------------------------------
+// Прогон
+// ----------------------------------------------------------
+
+int run(uint64_t rolls, unsigned threads, bool seeded, uint64_t seed) {
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency();
+  }
+  if (threads == 0) {
+    threads = 1;
+  }
+  if (!seeded) {
+    // Как DiceRng::seedFromHardware() в setup()
+    seed = (static_cast<uint64_t>(esp_random()) << 32) | esp_random();
+  }
+
+  printf("fairness: %llu rolls of %ud%u on %u threads, seed 0x%016llX\n",
+         static_cast<unsigned long long>(rolls), COUNT, FACES, threads, static_cast<unsigned long long>(seed));
+
+  // Потоки: общий засев, k прыжков для k-го - последовательности не пересекаются
+  DiceRng::Generator generator;
+  generator.seed(seed);
+  std::vector<Shard>       shards(threads);
+  std::vector<std::thread> workers;
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned t = 0; t < threads; ++t) {
+    const uint64_t share = rolls / threads + (t < rolls % threads ? 1 : 0);
+    workers.emplace_back(rollShard, generator, share, std::ref(shards[t]));
+    generator.jump();
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  Shard total;
+  for (const Shard& shard : shards) {
+    merge(total, shard);
+  }
+  const double n = static_cast<double>(total.rolls);
+  printf("  %.3f s, %.1f M rolls/s (%.1f M per thread)\n",
+         seconds, n / seconds / 1e6, n / seconds / 1e6 / threads);
+  if (total.rolls < 2) {
+    return 0;
+  }
+
+  bool ok = true;
+
+  // Грани всех кубиков
+  std::vector<double> observed, expected;
+  for (int f = 1; f <= FACES; ++f) {
+    observed.push_back(static_cast<double>(total.faces[f]));
+    expected.push_back(n * COUNT / FACES);
+  }
+  ok &= reportChi("faces", chiSquare(observed, expected));
+
+  // Суммы против точного распределения
+  const std::vector<double> ways = sumWays();
+  const double outcomes = pow(static_cast<double>(FACES), COUNT);
+  observed.clear();
+  expected.clear();
+  printf("  %4s %14s %14s %9s  %s\n", "sum", "observed", "expected", "dev_sigma", "colour");
+  for (int s = MIN_SUM; s <= MAX_SUM; ++s) {
+    const double o = static_cast<double>(total.sums[s]);
+    const double e = n * ways[s] / outcomes;
+    observed.push_back(o);
+    expected.push_back(e);
+    printf("  %4d %14.0f %14.1f %9.2f  0x%04X\n", s, o, e, e > 0.0 ? (o - e) / sqrt(e) : 0.0, getColorForSum(s));
+  }
+  ok &= reportChi("sums", chiSquare(observed, expected));
+
+  // Цвет результата: доли цветов против суммы вероятностей их сумм
+  std::vector<double> colorObserved(LEVEL_COUNT, 0.0), colorExpected(LEVEL_COUNT, 0.0);
+  for (int s = MIN_SUM; s <= MAX_SUM; ++s) {
+    const int level = levelOf(getColorForSum(s));
+    if (level >= 0) {
+      colorObserved[level] += static_cast<double>(total.sums[s]);
+      colorExpected[level] += n * ways[s] / outcomes;
+    }
+  }
+  ok &= reportChi("sum colours", chiSquare(colorObserved, colorExpected));
+
+  // Пары соседних бросков (первый кубик): независимость бросков
+  observed.clear();
+  expected.clear();
+  const double pairs = static_cast<double>(total.lagPairs);
+  for (int a = 0; a < FACES; ++a) {
+    for (int b = 0; b < FACES; ++b) {
+      observed.push_back(static_cast<double>(total.pairs[a][b]));
+      expected.push_back(pairs / (FACES * FACES));
+    }
+  }
+  ok &= reportChi("serial pairs", chiSquare(observed, expected));
+
+  // Корреляция соседних сумм: около нуля, разброс ~ 1/sqrt(n)
+  const long double m   = total.lagPairs;
+  const long double cov = m * total.sumXY - static_cast<long double>(total.sumX) * total.sumY;
+  const long double vx  = m * total.sumXX - static_cast<long double>(total.sumX) * total.sumX;
+  const long double vy  = m * total.sumYY - static_cast<long double>(total.sumY) * total.sumY;
+  const double r = (vx > 0 && vy > 0) ? static_cast<double>(cov / sqrtl(vx * vy)) : 0.0;
+  const double z = r * sqrt(pairs);
+  const bool correlationOk = fabs(z) < MAX_Z;
+  printf("  %-22s r %+.3e  z %+.2f  %s\n", "serial correlation", r, z, correlationOk ? "ok" : "FAIL");
+  ok &= correlationOk;
+
+  ok &= checkColorScale();
+
+  printf("fairness: %s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
+
+} // namespace FairnessBench
+
+#endif // !defined(ESP32)
@@ -0,0 +1,218 @@
+// Хост-программа; у тестов (pio test -e native) свой main() из test/
+#if !defined(ESP32) && !defined(PIO_UNIT_TESTING)
+
+#include <Arduino.h>
+#include <Adafruit_ST7735.h>
+#include <esp_system.h>
+
+#include <chrono>
+#include <string>
+
+#include "boot_timeline.h"
+#include "button_input.h"
+#include "config.h"
+#include "dice_rng.h"
+#include "event_log.h"
+#include "fairness_bench.h"
+#include "host_pins.h"
+#include "host_scenario.h"
+#include "loop_trace.h"
+#include "mock_tft_bus.h"
+#include "renderer.h"
+#include "roll_animation.h"
+#include "roll_history.h"
+
+// ----------------------------------------------------------
+// Точка входа хост-сборки [env:native]: прогоняет setup()/loop()
+// на виртуальных часах по сценарию из командной строки.
+//
+//   --seconds N         длительность прогона (виртуальные секунды)
+//   --press MS          короткое нажатие кнопки в момент MS
+//   --hold MS           долгое нажатие (LONG_PRESS_MS + 100 мс)
+//   --double MS         два коротких нажатия подряд (двойной клик)
+//   --bounce MS         короткое нажатие с дребезгом контактов на обоих фронтах
+//   --edge MS:LEVEL     отдельный фронт: уровень 0/1 на входе кнопки в момент MS
+//   --frame MS:FILE     снимок экрана в PPM в момент MS
+//   --serial MS:TEXT    подать TEXT в Serial в момент MS
+//   --seed N            детерминированный засев бросков (повтор последовательности)
+//   --frame-cost US     каждый кадр отрисовки занимает ещё US мкс (синхронный режим)
+//   --render-thread     выполнять команды отрисовки в отдельном std::thread
+//   --verbose           не глушить вывод Serial
+//   --decode-log FILE   расшифровать снятый с платы поток Serial (журнал
+//                       событий, см. event_log.h) в текст и выйти
+//   --trace-json FILE   снятый вывод трассы loop() ('t', см. loop_trace.h)
+//                       -> JSON trace_event в stdout и выйти
+//   --fairness N        N бросков по всем ядрам, проверка честности и
+//                       скорость (fairness_bench.h) вместо прогона; с --seed -
+//                       повторяемо, код возврата 1 при провале
+//   --threads N         число потоков для --fairness (по умолчанию - ядра)
+//
+// Без параметров: одно нажатие на 3-й секунде и полный цикл
+// бросок -> результат -> таймер -> алерт.
+// ----------------------------------------------------------
+
+extern MockTftBus tftDmaBus;
+
+namespace {
+
+bool splitTimed(const char* arg, unsigned long& at, std::string& text) {
+  const char* colon = strchr(arg, ':');
+  if (colon == nullptr) {
+    return false;
+  }
+  at   = strtoul(arg, nullptr, 10);
+  text = colon + 1;
+  return true;
+}
+
+// Поток байт из монитора порта -> текст в stdout
+int decodeLog(const char* path) {
+  FILE* file = fopen(path, "rb");
+  if (file == nullptr) {
+    fprintf(stderr, "cannot open %s\n", path);
+    return 1;
+  }
+  EventLog::Decoder decoder;
+  Serial.muted = false;
+  for (int byte = fgetc(file); byte != EOF; byte = fgetc(file)) {
+    decoder.feed(static_cast<uint8_t>(byte), Serial);
+  }
+  fclose(file);
+  fprintf(stderr, "decoded %u records, %u corrupt\n", decoder.records, decoder.corrupt);
+  return decoder.corrupt == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  unsigned long durationMs = (Config::Timer::DURATION_SEC + Config::Timer::RESULT_DISPLAY_SEC + 20) * 1000UL;
+  bool verbose = false;
+  bool seeded  = false;
+  bool renderThreaded = false;
+  unsigned long long seed = 0;
+  unsigned long long fairnessRolls = 0;
+  unsigned fairnessThreads = 0;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    unsigned long at = 0;
+    std::string text;
+
+    if (arg == "--verbose") {
+      verbose = true;
+    } else if (arg == "--render-thread") {
+      Renderer::setHostThreaded(true);
+      renderThreaded = true;
+    } else if (value == nullptr) {
+      fprintf(stderr, "missing value for %s\n", arg.c_str());
+      return 2;
+    } else if (arg == "--decode-log") {
+      return decodeLog(value);
+    } else if (arg == "--trace-json") {
+      Serial.muted = false;
+      if (!LoopTrace::writeChromeJson(value, Serial)) {
+        fprintf(stderr, "no loop trace spans in %s\n", value);
+        return 1;
+      }
+      return 0;
+    } else if (arg == "--fairness") {
+      fairnessRolls = static_cast<unsigned long long>(strtod(value, nullptr)); // и 1e9
+      ++i;
+    } else if (arg == "--threads") {
+      fairnessThreads = static_cast<unsigned>(strtoul(value, nullptr, 10));
+      ++i;
+    } else if (arg == "--seconds") {
+      durationMs = strtoul(value, nullptr, 10) * 1000UL;
+      ++i;
+    } else if (arg == "--frame-cost") {
+      Renderer::setHostFrameCostUs(strtoul(value, nullptr, 10));
+      ++i;
+    } else if (arg == "--seed") {
+      seed   = strtoull(value, nullptr, 0);
+      seeded = true;
+      ++i;
+    } else if (arg == "--press") {
+      HostScenario::press(strtoul(value, nullptr, 10), Config::Input::DEBOUNCE_MS * 2);
+      ++i;
+    } else if (arg == "--hold") {
+      HostScenario::press(strtoul(value, nullptr, 10), Config::Input::LONG_PRESS_MS + 100);
+      ++i;
+    } else if (arg == "--double") {
+      const unsigned long first = strtoul(value, nullptr, 10);
+      HostScenario::press(first, Config::Input::DEBOUNCE_MS * 2);
+      HostScenario::press(first + Config::Input::DEBOUNCE_MS * 4, Config::Input::DEBOUNCE_MS * 2);
+      ++i;
+    } else if (arg == "--bounce") {
+      HostScenario::bouncyPress(strtoul(value, nullptr, 10), Config::Input::DEBOUNCE_MS * 2);
+      ++i;
+    } else if (arg == "--edge" && splitTimed(value, at, text)) {
+      HostScenario::edge(at, text == "0" ? LOW : HIGH);
+      ++i;
+    } else if (arg == "--frame" && splitTimed(value, at, text)) {
+      HostScenario::frame(at, text.c_str());
+      ++i;
+    } else if (arg == "--serial" && splitTimed(value, at, text)) {
+      HostScenario::serial(at, text.c_str());
+      ++i;
+    } else {
+      fprintf(stderr, "unknown argument %s\n", arg.c_str());
+      return 2;
+    }
+  }
+
+  if (fairnessRolls > 0) {
+    return FairnessBench::run(fairnessRolls, fairnessThreads, seeded, seed);
+  }
+
+  if (!HostScenario::hasButton()) {
+    HostScenario::press(3000, Config::Input::DEBOUNCE_MS * 2);
+  }
+
+  tftDmaBus.recording = false;
+  Serial.muted = !verbose;
+
+  const auto realStart = std::chrono::steady_clock::now();
+
+  HostScenario::begin(renderThreaded);
+  if (seeded) {
+    DiceRng::seed(seed);
+  }
+  const uint32_t loops = HostScenario::runUntil(durationMs);
+
+  Renderer::setHostThreaded(false);
+
+  const double realMs = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - realStart).count();
+
+  printf("virtual time: %lu ms, real time: %.1f ms, loop() passes: %u\n", millis(), realMs, loops);
+  printf("bus: %llu command bytes, %llu data bytes\n",
+         static_cast<unsigned long long>(tftDmaBus.commandBytes),
+         static_cast<unsigned long long>(tftDmaBus.dataBytes));
+  printf("boot: first frame %.1f ms, ready %.1f ms\n",
+         BootTimeline::atUs(BootTimeline::Stage::FirstFrame) / 1000.0,
+         BootTimeline::atUs(BootTimeline::Stage::Ready) / 1000.0);
+  printf("sound onsets: %u\n", HostPins::toneCount());
+  printf("render queue stalls: %u\n", Renderer::stallCount());
+  const Renderer::FrameStats frames = Renderer::frameStats();
+  printf("frames: %u drawn, draw time avg %llu us, max %u us, pip operations last roll %u\n", frames.frames,
+         static_cast<unsigned long long>(frames.frames ? frames.totalUs / frames.frames : 0), frames.maxUs,
+         frames.rollPipOperations);
+  const RollAnimation::Stats& animation = RollAnimation::stats();
+  printf("roll animation: %u rolls, %u frames, %u merged, %u skipped, max late %u us\n",
+         animation.rolls, animation.frames, animation.merged, animation.skipped, animation.maxLateUs);
+  const RollHistory::Stats& history = RollHistory::stats();
+  printf("history: %u rolls, %u pending, NVS writes %u (%u bytes)\n",
+         history.totalRolls, history.pending, history.nvsWrites, history.nvsBytes);
+  const ButtonInput::LatencyStats& button = ButtonInput::latencyStats();
+  printf("button: %u events, latency avg %llu us, max %u us, dropped edges %u\n",
+         button.events,
+         static_cast<unsigned long long>(button.events ? button.totalUs / button.events : 0),
+         button.maxUs, button.droppedEdges);
+  if (ESP.restartRequested) {
+    printf("stopped: ESP.restart() requested\n");
+  }
+  return 0;
+}
+
+#endif // !defined(ESP32) && !defined(PIO_UNIT_TESTING)
@@ -0,0 +1,137 @@
+#if !defined(ESP32)
+
+#include <Arduino.h>
+#include <Adafruit_ST7735.h>
+#include <esp_system.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "host_pins.h"
+#include "host_scenario.h"
+#include "mock_tft_bus.h"
+#include "renderer.h"
+#include "scheduler.h"
+
+void setup();
+void loop();
+
+extern MockTftBus tftDmaBus;
+
+// ----------------------------------------------------------
+// События сценария и прогон loop() между ними
+// ----------------------------------------------------------
+
+namespace HostScenario {
+
+namespace {
+
+enum class EventType : uint8_t { ButtonDown, ButtonUp, Frame, SerialInput };
+
+struct Event {
+  unsigned long at;
+  EventType     type;
+  std::string   text;
+};
+
+std::vector<Event> events;
+bool threaded = false;
+
+void run(const Event& event) {
+  switch (event.type) {
+    case EventType::ButtonDown:
+      HostPins::setInput(Config::Hardware::BUTTON_PIN, LOW);
+      break;
+    case EventType::ButtonUp:
+      HostPins::setInput(Config::Hardware::BUTTON_PIN, HIGH);
+      break;
+    case EventType::Frame:
+      Renderer::waitIdle();
+      tftDmaBus.savePpm(event.text.c_str(), Config::Display::WIDTH, Config::Display::HEIGHT);
+      break;
+    case EventType::SerialInput:
+      Serial.inject(event.text.c_str());
+      break;
+  }
+}
+
+} // namespace
+
+void press(unsigned long atMs, unsigned long durationMs) {
+  events.push_back({atMs, EventType::ButtonDown, ""});
+  events.push_back({atMs + durationMs, EventType::ButtonUp, ""});
+}
+
+void bouncyPress(unsigned long atMs, unsigned long durationMs) {
+  for (unsigned long t = 0; t < 4; ++t) {
+    events.push_back({atMs + t, (t % 2 == 0) ? EventType::ButtonDown : EventType::ButtonUp, ""});
+    events.push_back({atMs + durationMs + t, (t % 2 == 0) ? EventType::ButtonUp : EventType::ButtonDown, ""});
+  }
+  events.push_back({atMs + 4, EventType::ButtonDown, ""});
+  events.push_back({atMs + durationMs + 4, EventType::ButtonUp, ""});
+}
+
+void edge(unsigned long atMs, uint8_t level) {
+  events.push_back({atMs, level == LOW ? EventType::ButtonDown : EventType::ButtonUp, ""});
+}
+
+void frame(unsigned long atMs, const char* path) {
+  events.push_back({atMs, EventType::Frame, path});
+}
+
+void serial(unsigned long atMs, const char* text) {
+  events.push_back({atMs, EventType::SerialInput, text});
+}
+
+bool hasButton() {
+  for (const Event& e : events) {
+    if (e.type == EventType::ButtonDown) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void begin(bool renderThreaded) {
+  threaded = renderThreaded;
+  setup();
+}
+
+uint32_t runUntil(unsigned long endMs) {
+  uint32_t loops = 0;
+  while (millis() < endMs && !ESP.restartRequested) {
+    const unsigned long now = millis();
+    for (auto it = events.begin(); it != events.end();) {
+      if (it->at > now) {
+        ++it;
+        continue;
+      }
+      run(*it);
+      it = events.erase(it);
+    }
+
+    // loop() спит на виртуальных часах, но не дальше следующего события
+    // сценария и конца прогона
+    unsigned long wakeLimit = endMs;
+    for (const Event& e : events) {
+      wakeLimit = std::min(wakeLimit, e.at);
+    }
+    Scheduler::setHostWakeLimit(Scheduler::msToUs(wakeLimit));
+
+    // Поток отрисовки идёт в реальном времени, а сон loop() - виртуальный
+    // и мгновенный: считаем, что кадр успел отрисоваться за время сна
+    if (threaded) {
+      Renderer::waitIdle();
+    }
+
+    loop();
+    ++loops;
+  }
+  return loops;
+}
+
+} // namespace HostScenario
+
+#endif // !defined(ESP32)
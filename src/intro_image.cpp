@@ -0,0 +1,172 @@
+#include <Arduino.h>
+
+#include "intro_image.h"
+
+// ----------------------------------------------------------
+// Растеризация надписей и RLE при компиляции
+// ----------------------------------------------------------
+
+namespace IntroImage {
+
+namespace {
+
+// Глифы из glcdfont.c (только символы интро): 5 столбцов, младший бит - верхняя строка
+struct Glyph {
+  char    code;
+  uint8_t columns[5];
+};
+
+constexpr Glyph FONT[] = {
+  {'!', {0x00, 0x00, 0x5F, 0x00, 0x00}}, {'C', {0x3E, 0x41, 0x41, 0x41, 0x22}},
+  {'D', {0x7F, 0x41, 0x41, 0x41, 0x3E}}, {'E', {0x7F, 0x49, 0x49, 0x49, 0x41}},
+  {'I', {0x00, 0x41, 0x7F, 0x41, 0x00}}, {'L', {0x7F, 0x40, 0x40, 0x40, 0x40}},
+  {'O', {0x3E, 0x41, 0x41, 0x41, 0x3E}}, {'P', {0x7F, 0x09, 0x09, 0x09, 0x06}},
+  {'R', {0x7F, 0x09, 0x19, 0x29, 0x46}}, {'b', {0x7F, 0x28, 0x44, 0x44, 0x38}},
+  {'e', {0x38, 0x54, 0x54, 0x54, 0x18}}, {'l', {0x00, 0x41, 0x7F, 0x40, 0x00}},
+  {'n', {0x7C, 0x08, 0x04, 0x04, 0x78}}, {'o', {0x38, 0x44, 0x44, 0x44, 0x38}},
+  {'r', {0x7C, 0x08, 0x04, 0x04, 0x08}}, {'s', {0x48, 0x54, 0x54, 0x54, 0x24}},
+  {'t', {0x04, 0x04, 0x3F, 0x44, 0x24}}, {'u', {0x3C, 0x40, 0x40, 0x20, 0x7C}},
+};
+
+// Столбец глифа; пробел и символы не из таблицы - пустые
+constexpr uint8_t fontColumn(char code, uint8_t column) {
+  for (const Glyph& glyph : FONT) {
+    if (glyph.code == code) {
+      return glyph.columns[column];
+    }
+  }
+  return 0;
+}
+
+// Палитра картинки
+enum Ink : uint8_t { INK_BACKGROUND, INK_TITLE, INK_HINT };
+
+constexpr uint16_t PALETTE[] = {Config::Colors::BACKGROUND, Config::Colors::TITLE_TEXT, Config::Colors::HINT_TEXT};
+
+struct Text {
+  const char* text;
+  int16_t     x, y;
+  uint8_t     size;
+  Ink         ink;
+};
+
+// Те же строки и места, что печатал drawIntro()
+constexpr Text TEXTS[] = {
+  {"DICE",         Config::Intro::TITLE_DICE_X,   Config::Intro::TITLE_DICE_Y,   Config::Intro::TITLE_TEXT_SIZE, INK_TITLE},
+  {"ROLLER",       Config::Intro::TITLE_ROLLER_X, Config::Intro::TITLE_ROLLER_Y, Config::Intro::TITLE_TEXT_SIZE, INK_TITLE},
+  {"Press button", Config::Intro::HINT_LINE1_X,   Config::Intro::HINT_LINE1_Y,   Config::Intro::HINT_TEXT_SIZE,  INK_HINT},
+  {"to roll!",     Config::Intro::HINT_LINE2_X,   Config::Intro::HINT_LINE2_Y,   Config::Intro::HINT_TEXT_SIZE,  INK_HINT},
+};
+
+constexpr uint16_t textLength(const char* text) {
+  uint16_t length = 0;
+  while (text[length] != '\0') {
+    ++length;
+  }
+  return length;
+}
+
+// Символ ячейки 6x8 (в size раз крупнее) рисует только 5x8 - как drawChar()
+constexpr bool textPixel(const Text& item, int16_t x, int16_t y) {
+  const int16_t cellW = 6 * item.size;
+  if (x < item.x || y < item.y || y >= item.y + 8 * item.size ||
+      x >= item.x + cellW * textLength(item.text)) {
+    return false;
+  }
+  const uint8_t column = static_cast<uint8_t>(((x - item.x) % cellW) / item.size);
+  const uint8_t row    = static_cast<uint8_t>((y - item.y) / item.size);
+  return column < 5 && ((fontColumn(item.text[(x - item.x) / cellW], column) >> row) & 1);
+}
+
+// Надписи идут в порядке вывода: следующая перекрывает предыдущую
+constexpr Ink inkAt(int16_t x, int16_t y) {
+  Ink ink = INK_BACKGROUND;
+  for (const Text& item : TEXTS) {
+    if (textPixel(item, x, y)) {
+      ink = item.ink;
+    }
+  }
+  return ink;
+}
+
+// Байт серии: 2 бита палитры и 6 бит длины - 1; серии идут в порядке
+// развёртки через границы строк. out == nullptr - только подсчёт длины
+constexpr uint8_t  RUN_BITS = 6;
+constexpr uint8_t  MAX_RUN  = 1u << RUN_BITS;
+constexpr uint32_t PIXELS   = static_cast<uint32_t>(WIDTH) * HEIGHT;
+
+constexpr uint32_t encode(uint8_t* out) {
+  uint32_t length = 0;
+  Ink      ink    = inkAt(0, 0);
+  uint8_t  run    = 1;
+  for (uint32_t i = 1; i <= PIXELS; ++i) {
+    const Ink next = i < PIXELS ? inkAt(i % WIDTH, i / WIDTH) : ink;
+    if (i < PIXELS && next == ink && run < MAX_RUN) {
+      ++run;
+      continue;
+    }
+    if (out) {
+      out[length] = static_cast<uint8_t>((ink << RUN_BITS) | (run - 1));
+    }
+    ++length;
+    ink = next;
+    run = 1;
+  }
+  return length;
+}
+
+constexpr uint32_t RLE_BYTES = encode(nullptr);
+
+struct Image {
+  uint8_t runs[RLE_BYTES];
+};
+
+constexpr Image buildImage() {
+  Image image{};
+  encode(image.runs);
+  return image;
+}
+
+constexpr Image IMAGE = buildImage();
+
+// ----------------------------------------------------------
+// Распаковка строками в одно окно
+// ----------------------------------------------------------
+
+uint16_t lineBuffer[WIDTH];
+
+} // namespace
+
+uint32_t compressedBytes() {
+  return RLE_BYTES;
+}
+
+void draw(RenderTarget& target) {
+  DRAW_PROFILE_PRIMITIVE(Sprite);
+
+  target.setAddrWindow(0, 0, WIDTH, HEIGHT);
+
+  // Теневой кадр в памяти: серия целиком ложится отрезком индексов,
+  // буфер строки только лишняя копия
+  if constexpr (Config::Display::USE_SHADOW_FRAMEBUFFER) {
+    for (uint32_t i = 0; i < RLE_BYTES; ++i) {
+      target.pushColor(PALETTE[IMAGE.runs[i] >> RUN_BITS], (IMAGE.runs[i] & (MAX_RUN - 1)) + 1u);
+    }
+    return;
+  }
+
+  // Панель напрямую: строка собирается в буфер и уходит одной передачей
+  uint16_t filled = 0;
+  for (uint32_t i = 0; i < RLE_BYTES; ++i) {
+    const uint16_t color = PALETTE[IMAGE.runs[i] >> RUN_BITS];
+    for (uint8_t run = (IMAGE.runs[i] & (MAX_RUN - 1)) + 1; run > 0; --run) {
+      lineBuffer[filled++] = color;
+      if (filled == WIDTH) {
+        target.pushPixels(lineBuffer, WIDTH);
+        filled = 0;
+      }
+    }
+  }
+}
+
+} // namespace IntroImage
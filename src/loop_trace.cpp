@@ -0,0 +1,244 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <Adafruit_ST7735.h>
+
+#include "config.h"
+#include "loop_trace.h"
+
+// ----------------------------------------------------------
+// Дорожки, гистограммы и кольцо отрезков
+// ----------------------------------------------------------
+
+namespace LoopTrace {
+
+namespace {
+
+constexpr uint8_t TRACK_COUNT = static_cast<uint8_t>(Track::COUNT);
+
+// Без пробелов: имя - одно слово в строке отрезка
+const char* const TRACK_NAMES[TRACK_COUNT] = {
+  "loop", "handleButtonPress",
+  "handleDiceAnimation", "handleResultDisplay", "handleTimer", "handleAlert", "buttonCheck", "handleHistoryFlush"
+};
+
+} // namespace
+
+} // namespace LoopTrace
+
+#if defined(LOOP_TRACE)
+
+namespace LoopTrace {
+
+namespace {
+
+const uint32_t MISS_US[TRACK_COUNT] = {
+  Config::Trace::OTHER_MISS_US, Config::Trace::BUTTON_MISS_US,
+  Config::Trace::FRAME_MISS_US, Config::Trace::OTHER_MISS_US, Config::Trace::TIMER_MISS_US,
+  Config::Trace::BLINK_MISS_US, Config::Trace::OTHER_MISS_US, Config::Trace::OTHER_MISS_US
+};
+
+// Корзины опоздания: границы растут вчетверо, последняя - всё остальное
+constexpr uint8_t BUCKET_COUNT = 8;
+
+const char* const BUCKET_NAMES[BUCKET_COUNT] = {"<16", "<64", "<256", "<1k", "<4k", "<16k", "<64k", ">=64k"};
+
+uint8_t bucketOf(uint32_t lateUs) {
+  uint8_t bucket = 0;
+  for (uint32_t limit = 16; bucket < BUCKET_COUNT - 1 && lateUs >= limit; limit *= 4) {
+    ++bucket;
+  }
+  return bucket;
+}
+
+struct Stats {
+  uint32_t runs;
+  uint32_t missed;
+  uint32_t maxLateUs;
+  uint32_t maxRunUs;
+  uint32_t buckets[BUCKET_COUNT];
+};
+
+struct Span {
+  uint32_t startUs;
+  uint32_t durationUs;
+  uint32_t lateUs;
+  Track    track;
+  bool     missed;
+};
+
+Stats    stats[TRACK_COUNT];
+Span     spans[Config::Trace::SPANS];
+uint32_t spanCount = 0; // всего с последнего сброса; в кольце - последние SPANS
+
+uint64_t passStartUs  = 0;
+uint64_t passTargetUs = 0;
+uint64_t wakeTargetUs = 0; // 0 - loop() ещё ни разу не засыпал
+
+void record(Track track, uint64_t startUs, uint64_t endUs, uint64_t targetUs) {
+  const uint32_t lateUs     = startUs > targetUs ? static_cast<uint32_t>(startUs - targetUs) : 0;
+  const uint32_t durationUs = static_cast<uint32_t>(endUs - startUs);
+  const bool     missed     = lateUs > MISS_US[static_cast<uint8_t>(track)];
+
+  Stats& s = stats[static_cast<uint8_t>(track)];
+  ++s.runs;
+  s.missed += missed;
+  if (lateUs > s.maxLateUs) {
+    s.maxLateUs = lateUs;
+  }
+  if (durationUs > s.maxRunUs) {
+    s.maxRunUs = durationUs;
+  }
+  ++s.buckets[bucketOf(lateUs)];
+
+  spans[spanCount % Config::Trace::SPANS] = {static_cast<uint32_t>(startUs), durationUs, lateUs, track, missed};
+  ++spanCount;
+}
+
+} // namespace
+
+Scope::Scope(Track track, uint64_t targetUs)
+    : track(track), startUs(static_cast<uint64_t>(esp_timer_get_time())), targetUs(targetUs) {}
+
+Scope::~Scope() {
+  record(track, startUs, static_cast<uint64_t>(esp_timer_get_time()), targetUs);
+}
+
+void passBegin() {
+  passStartUs = static_cast<uint64_t>(esp_timer_get_time());
+  // Раннее пробуждение (фронт кнопки) опозданием не считается
+  passTargetUs = wakeTargetUs != 0 ? wakeTargetUs : passStartUs;
+}
+
+void passEnd() {
+  record(Track::Pass, passStartUs, static_cast<uint64_t>(esp_timer_get_time()), passTargetUs);
+}
+
+void plannedWake(uint64_t wakeAtUs) {
+  wakeTargetUs = wakeAtUs;
+}
+
+// ----------------------------------------------------------
+// Сводка и выгрузка
+// ----------------------------------------------------------
+
+void reset() {
+  memset(stats, 0, sizeof(stats));
+  spanCount = 0;
+}
+
+void report(Print& out) {
+  out.println("--- loop trace ---");
+  out.printf("%-20s %7s %6s %9s %9s", "track", "runs", "missed", "late_max", "run_max");
+  for (uint8_t b = 0; b < BUCKET_COUNT; ++b) {
+    out.printf(" %6s", BUCKET_NAMES[b]);
+  }
+  out.println();
+
+  for (uint8_t t = 0; t < TRACK_COUNT; ++t) {
+    const Stats& s = stats[t];
+    if (s.runs == 0) {
+      continue;
+    }
+    out.printf("%-20s %7lu %6lu %9lu %9lu", TRACK_NAMES[t],
+               static_cast<unsigned long>(s.runs), static_cast<unsigned long>(s.missed),
+               static_cast<unsigned long>(s.maxLateUs), static_cast<unsigned long>(s.maxRunUs));
+    for (uint8_t b = 0; b < BUCKET_COUNT; ++b) {
+      out.printf(" %6lu", static_cast<unsigned long>(s.buckets[b]));
+    }
+    out.println();
+  }
+
+  // Отрезки от старых к новым: T дорожка начало длительность опоздание промах
+  const uint32_t kept  = spanCount < Config::Trace::SPANS ? spanCount : Config::Trace::SPANS;
+  const uint32_t first = spanCount - kept;
+  out.printf("spans: last %lu of %lu\n", static_cast<unsigned long>(kept), static_cast<unsigned long>(spanCount));
+  for (uint32_t i = first; i < spanCount; ++i) {
+    const Span& span = spans[i % Config::Trace::SPANS];
+    out.printf("T %s %lu %lu %lu %u\n", TRACK_NAMES[static_cast<uint8_t>(span.track)],
+               static_cast<unsigned long>(span.startUs), static_cast<unsigned long>(span.durationUs),
+               static_cast<unsigned long>(span.lateUs), static_cast<unsigned>(span.missed));
+  }
+  out.println("--- end loop trace ---");
+}
+
+void command(char c) {
+  switch (c) {
+    case 't':
+      report(Serial);
+      break;
+    case 'r':
+      reset();
+      Serial.println("loop trace reset");
+      break;
+  }
+}
+
+} // namespace LoopTrace
+
+#endif // defined(LOOP_TRACE)
+
+#if !defined(ESP32)
+
+// ----------------------------------------------------------
+// Хост: строки отрезков -> JSON trace_event
+// ----------------------------------------------------------
+
+namespace LoopTrace {
+
+bool writeChromeJson(const char* path, Print& out) {
+  FILE* file = fopen(path, "r");
+  if (file == nullptr) {
+    return false;
+  }
+
+  // Каждая дорожка - отдельный поток в просмотрщике, опоздание - свой отрезок перед работой
+  out.print("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  for (uint8_t t = 0; t < TRACK_COUNT; ++t) {
+    out.printf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}},\n",
+               static_cast<unsigned>(t), TRACK_NAMES[t]);
+  }
+
+  uint32_t spanLines = 0;
+  char line[160];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    char name[32];
+    unsigned long startUs = 0, durationUs = 0, lateUs = 0;
+    unsigned missed = 0;
+    if (sscanf(line, "T %31s %lu %lu %lu %u", name, &startUs, &durationUs, &lateUs, &missed) != 5) {
+      continue;
+    }
+    uint8_t tid = 0;
+    while (tid < TRACK_COUNT && strcmp(TRACK_NAMES[tid], name) != 0) {
+      ++tid;
+    }
+    if (tid == TRACK_COUNT) {
+      continue;
+    }
+
+    if (lateUs > 0) {
+      out.printf("{\"name\":\"late\",\"cat\":\"late\",\"ph\":\"X\",\"ts\":%lu,\"dur\":%lu,\"pid\":1,\"tid\":%u},\n",
+                 startUs - lateUs, lateUs, static_cast<unsigned>(tid));
+    }
+    if (missed != 0) {
+      out.printf("{\"name\":\"deadline miss\",\"cat\":\"miss\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%lu,\"pid\":1,"
+                 "\"tid\":%u,\"args\":{\"late_us\":%lu}},\n",
+                 startUs, static_cast<unsigned>(tid), lateUs);
+    }
+    out.printf("{\"name\":\"%s\",\"cat\":\"loop\",\"ph\":\"X\",\"ts\":%lu,\"dur\":%lu,\"pid\":1,\"tid\":%u,"
+               "\"args\":{\"late_us\":%lu}},\n",
+               name, startUs, durationUs, static_cast<unsigned>(tid), lateUs);
+    ++spanLines;
+  }
+  fclose(file);
+
+  // Завершающая запись без запятой - JSON остаётся валидным
+  out.print("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"IceDice loop()\"}}\n]}\n");
+  return spanLines > 0;
+}
+
+} // namespace LoopTrace
+
+#endif // !defined(ESP32)
@@ -1,11 +1,20 @@
 #include <Arduino.h>
-#include <Adafruit_GFX.h>
 #include <Adafruit_ST7735.h>
-#include <SPI.h>
-#include <esp_system.h>
 #include <Preferences.h>
 
+#include "audio.h"
+#include "boot_timeline.h"
+#include "button_input.h"
 #include "config.h"
+#include "dice_rng.h"
+#include "draw_profiler.h"
+#include "event_log.h"
+#include "loop_trace.h"
+#include "melodies.h"
+#include "renderer.h"
+#include "roll_animation.h"
+#include "roll_history.h"
+#include "scheduler.h"
 
 // ----------------------------------------------------------
 // Типы и глобальные объекты
@@ -20,56 +29,27 @@ enum class AppState : uint8_t {
   AlertActive     // Мигающий алерт
 };
 
-// Объект дисплея с использованием конфигурации пинов
-Adafruit_ST7735 tft(
-  Config::Hardware::TFT_CS,
-  Config::Hardware::TFT_DC,
-  Config::Hardware::TFT_MOSI,
-  Config::Hardware::TFT_SCLK,
-  Config::Hardware::TFT_RST
-);
+#if defined(DRAW_PROFILER)
+// Имена состояний для отчёта профилировщика (порядок как в AppState)
+const char* const APP_STATE_NAMES[] = {
+  "DiceRollNext", "DiceTimerNext", "DiceAnimating", "ResultDisplay", "TimerRunning", "AlertActive"
+};
+#endif
 
 // Текущее состояние приложения
 AppState appState = AppState::DiceRollNext;
 
-// Состояние кубиков
-int lastDice1 = 0;
-int lastDice2 = 0;
-
-// Анимация броска
-int animationCurrentDice1 = 0;
-int animationCurrentDice2 = 0;
-int animationTargetDice1  = 0;
-int animationTargetDice2  = 0;
-uint8_t animationFrame    = 0;
-unsigned long lastFrameTime = 0;
+// Состояние кубиков (0 - грань ещё не выпадала)
+uint8_t lastDice[Config::Dice::COUNT] = {};
 
-// Показ результата броска
-unsigned long resultDisplayStartTime = 0;
 
-// Таймер
-unsigned long timerStartTime   = 0;
-unsigned long lastSecondUpdate = 0;
-int lastRemainingSeconds       = -1; // для частичного обновления таймера
-uint16_t lastTimerColor        = 0;
+// Таймер (секунды отсчитываются от timerStartUs, а не от момента обработки)
+uint64_t timerStartUs          = 0;
 
 // Алерт
 bool alertVisible        = true;
-unsigned long lastBlinkTime = 0;
-
-// Кнопка (антидребезг)
-int buttonStableState    = HIGH;
-int lastButtonReading    = HIGH;
-unsigned long lastDebounceTime = 0;
-bool buttonPressedEvent     = false;
-bool longButtonPressedEvent = false;
-unsigned long buttonPressStartTime = 0;
-bool isLongPressHandled     = false;
 
 // Музыка
-int currentNoteIndex      = 0;
-unsigned long lastNoteTime = 0;
-bool melodyPlaying        = false;
 uint8_t currentMelodyIndex = 0;
 bool melodyHasPlayed      = false;  // Флаг для отслеживания, что мелодия уже была проиграна
 
@@ -78,223 +58,64 @@ Preferences preferences;
 // Прототипы функций
 // ----------------------------------------------------------
 
-void drawDice(int x, int y, int value, int oldValue, uint16_t fillColor, bool isInitialDraw = false);
-void drawAlert(bool visible);
-void drawTimer(int remainingSeconds, uint16_t color);
+void finishAlert();
 uint16_t getColorForSum(int sum);
-
-void updateButton(unsigned long now);
-void handleButtonPress(unsigned long now);
-void handleDiceAnimation(unsigned long now);
-void handleResultDisplay(unsigned long now);
-void handleTimer(unsigned long now);
-void handleAlert(unsigned long now);
-void handleIntroMelody(unsigned long now);
-
-void startDiceRoll(unsigned long now);
-void startTimer(unsigned long now);
+int sumOf(const uint8_t* dice);
+
+void scheduleButtonCheck();
+void pollDebugCommands();
+void handleButtonPress(const ButtonInput::Event& event, uint64_t now);
+void handleDiceAnimation(uint64_t deadlineUs);
+void handleResultDisplay(uint64_t deadlineUs);
+void handleTimer(uint64_t deadlineUs);
+void handleAlert(uint64_t deadlineUs);
+void handleHistoryFlush(uint64_t deadlineUs);
+
+void startDiceRoll(uint64_t now);
+void startTimer(uint64_t now);
 void showIntro();
 void startIntroMelody();
 
 // ----------------------------------------------------------
-// Отрисовка кубика
+// Выход из алерта
 // ----------------------------------------------------------
 
-void drawDice(int x, int y, int value, int oldValue, uint16_t fillColor, bool isInitialDraw) {
-  const uint16_t DICE_SIZE   = Config::Dice::SIZE;
-  const uint16_t DICE_RADIUS = Config::Dice::RADIUS;
-  const uint16_t DOT_RADIUS  = Config::Dice::DOT_RADIUS;
-
-  if (isInitialDraw) {
-    tft.fillRoundRect(x, y, DICE_SIZE, DICE_SIZE, DICE_RADIUS, fillColor);
-    tft.drawRoundRect(x, y, DICE_SIZE, DICE_SIZE, DICE_RADIUS, Config::Colors::DICE_BORDER);
-  }
-
-  int center = x + DICE_SIZE / 2;
-  int left   = x + DICE_SIZE / 4;
-  int right  = x + (DICE_SIZE * 3) / 4;
-  int top    = y + DICE_SIZE / 4;
-  int middle = y + DICE_SIZE / 2;
-  int bottom = y + (DICE_SIZE * 3) / 4;
-
-  // Стираем старые точки (рисуем их цветом фона кубика)
-  if (oldValue > 0) {
-    switch (oldValue) {
-      case 1:
-        tft.fillCircle(center, middle, DOT_RADIUS, fillColor);
-        break;
-      case 2:
-        tft.fillCircle(left,  top,    DOT_RADIUS, fillColor);
-        tft.fillCircle(right, bottom, DOT_RADIUS, fillColor);
-        break;
-      case 3:
-        tft.fillCircle(left,   top,    DOT_RADIUS, fillColor);
-        tft.fillCircle(center, middle, DOT_RADIUS, fillColor);
-        tft.fillCircle(right,  bottom, DOT_RADIUS, fillColor);
-        break;
-      case 4:
-        tft.fillCircle(left,  top,    DOT_RADIUS, fillColor);
-        tft.fillCircle(right, top,    DOT_RADIUS, fillColor);
-        tft.fillCircle(left,  bottom, DOT_RADIUS, fillColor);
-        tft.fillCircle(right, bottom, DOT_RADIUS, fillColor);
-        break;
-      case 5:
-        tft.fillCircle(left,   top,    DOT_RADIUS, fillColor);
-        tft.fillCircle(right,  top,    DOT_RADIUS, fillColor);
-        tft.fillCircle(center, middle, DOT_RADIUS, fillColor);
-        tft.fillCircle(left,   bottom, DOT_RADIUS, fillColor);
-        tft.fillCircle(right,  bottom, DOT_RADIUS, fillColor);
-        break;
-      case 6:
-        tft.fillCircle(left,  top,    DOT_RADIUS, fillColor);
-        tft.fillCircle(left,  middle, DOT_RADIUS, fillColor);
-        tft.fillCircle(left,  bottom, DOT_RADIUS, fillColor);
-        tft.fillCircle(right, top,    DOT_RADIUS, fillColor);
-        tft.fillCircle(right, middle, DOT_RADIUS, fillColor);
-        tft.fillCircle(right, bottom, DOT_RADIUS, fillColor);
-        break;
-    }
-  }
-
-  // Рисуем новые точки
-  switch (value) {
-    case 1:
-      tft.fillCircle(center, middle, DOT_RADIUS, Config::Colors::DICE_PIP);
-      break;
-    case 2:
-      tft.fillCircle(left,  top,    DOT_RADIUS, Config::Colors::DICE_PIP);
-      tft.fillCircle(right, bottom, DOT_RADIUS, Config::Colors::DICE_PIP);
-      break;
-    case 3:
-      tft.fillCircle(left,   top,    DOT_RADIUS, Config::Colors::DICE_PIP);
-      tft.fillCircle(center, middle, DOT_RADIUS, Config::Colors::DICE_PIP);
-      tft.fillCircle(right,  bottom, DOT_RADIUS, Config::Colors::DICE_PIP);
-      break;
-    case 4:
-      tft.fillCircle(left,  top,    DOT_RADIUS, Config::Colors::DICE_PIP);
-      tft.fillCircle(right, top,    DOT_RADIUS, Config::Colors::DICE_PIP);
-      tft.fillCircle(left,  bottom, DOT_RADIUS, Config::Colors::DICE_PIP);
-      tft.fillCircle(right, bottom, DOT_RADIUS, Config::Colors::DICE_PIP);
-      break;
-    case 5:
-      tft.fillCircle(left,   top,    DOT_RADIUS, Config::Colors::DICE_PIP);
-      tft.fillCircle(right,  top,    DOT_RADIUS, Config::Colors::DICE_PIP);
-      tft.fillCircle(center, middle, DOT_RADIUS, Config::Colors::DICE_PIP);
-      tft.fillCircle(left,   bottom, DOT_RADIUS, Config::Colors::DICE_PIP);
-      tft.fillCircle(right,  bottom, DOT_RADIUS, Config::Colors::DICE_PIP);
-      break;
-    case 6:
-      tft.fillCircle(left,  top,    DOT_RADIUS, Config::Colors::DICE_PIP);
-      tft.fillCircle(left,  middle, DOT_RADIUS, Config::Colors::DICE_PIP);
-      tft.fillCircle(left,  bottom, DOT_RADIUS, Config::Colors::DICE_PIP);
-      tft.fillCircle(right, top,    DOT_RADIUS, Config::Colors::DICE_PIP);
-      tft.fillCircle(right, middle, DOT_RADIUS, Config::Colors::DICE_PIP);
-      tft.fillCircle(right, bottom, DOT_RADIUS, Config::Colors::DICE_PIP);
-      break;
+// Командные режимы мигания могли оставить панель выключенной или инвертированной
+void finishAlert() {
+  if (Config::Alert::BLINK_MODE != Config::Alert::BlinkMode::Redraw && !alertVisible) {
+    Renderer::blink(true);
   }
+  alertVisible = true;
 }
 
 // ----------------------------------------------------------
-// Отрисовка мигающего алерта
+// Отладочные команды из Serial
 // ----------------------------------------------------------
 
-void drawAlert(bool visible) {
-  if (visible) {
-    const int16_t centerX = Config::Display::WIDTH / 2;
-    const int16_t topY    = Config::Alert::TRI_TOP_Y;
-    const int16_t bottomY = Config::Display::HEIGHT - Config::Alert::TRI_BOTTOM_MARGIN;
-    const int16_t leftX   = Config::Alert::TRI_HORIZONTAL_MARGIN;
-    const int16_t rightX  = Config::Display::WIDTH - Config::Alert::TRI_HORIZONTAL_MARGIN;
-
-    tft.fillTriangle(
-      centerX, topY,
-      leftX,   bottomY,
-      rightX,  bottomY,
-      Config::Colors::ALERT
-    );
-
-    // Знак "!" внутри треугольника
-    tft.fillRect(centerX - 8, 30, 16, 50, Config::Colors::BACKGROUND);
-    tft.fillRect(centerX - 8, 90, 16, 16, Config::Colors::BACKGROUND);
-  } else {
-    // В оригинале при скрытии полностью очищался экран
-    tft.fillScreen(Config::Colors::BACKGROUND);
+// 'p' - профиль отрисовки, 't' - трасса loop(), 'r' - сброс
+// (только в сборках с -DDRAW_PROFILER или -DLOOP_TRACE)
+void pollDebugCommands() {
+#if defined(DRAW_PROFILER) || defined(LOOP_TRACE)
+  while (Serial.available() > 0) {
+    const char command = static_cast<char>(Serial.read());
+    DRAW_PROFILE_COMMAND(command, APP_STATE_NAMES, sizeof(APP_STATE_NAMES) / sizeof(APP_STATE_NAMES[0]));
+    LOOP_TRACE_COMMAND(command);
   }
+#endif
 }
 
 // ----------------------------------------------------------
-// Отрисовка таймера
+// Пробуждение для кнопки
 // ----------------------------------------------------------
 
-void drawTimer(int remainingSeconds, uint16_t color) {
-  // Оптимизация: если и время, и цвет не изменились, выходим
-  if (lastRemainingSeconds == remainingSeconds && lastTimerColor == color) {
-    return;
-  }
-
-  tft.setTextSize(Config::Timer::TEXT_SIZE);
-  tft.setTextColor(color, Config::Colors::BACKGROUND);
-
-  // При первом запуске таймера - очищаем весь экран
-  if (lastRemainingSeconds == -1) {
-    tft.fillScreen(Config::Colors::BACKGROUND);
-  }
-
-  char timeStr[4];
-  snprintf(timeStr, sizeof(timeStr), "%02d", remainingSeconds);
-
-  int16_t x1, y1;
-  uint16_t w, h;
-  tft.getTextBounds(timeStr, 0, 0, &x1, &y1, &w, &h);
-
-  int16_t x = (Config::Display::WIDTH  - static_cast<int16_t>(w)) / 2;
-  int16_t y = (Config::Display::HEIGHT - static_cast<int16_t>(h)) / 2
-              + Config::Timer::CENTER_Y_OFFSET;
-
-  tft.setCursor(x, y);
-  tft.print(timeStr);
-
-  lastRemainingSeconds = remainingSeconds;
-  lastTimerColor       = color;
-}
-
-// ----------------------------------------------------------
-// Обработка кнопки (антидребезг, событие нажатия)
-// ----------------------------------------------------------
-
-void updateButton(unsigned long now) {
-  int reading = digitalRead(Config::Hardware::BUTTON_PIN);
-
-  if (reading != lastButtonReading) {
-    lastDebounceTime   = now;
-    lastButtonReading  = reading;
-  }
-
-  if ((now - lastDebounceTime) >= Config::Input::DEBOUNCE_MS) {
-    if (reading != buttonStableState) {
-      buttonStableState = reading;
-      if (buttonStableState == LOW) { // Кнопка только что была нажата
-        buttonPressStartTime = now;
-        isLongPressHandled = false;
-        Serial.println("Button pressed, starting timer for long press detection");
-      } else { // Кнопка только что была отпущена
-        if (!isLongPressHandled) {
-          // Если долгое нажатие не было обработано, это обычное короткое нажатие
-          buttonPressedEvent = true;
-          Serial.println("Short press detected");
-        }
-        buttonPressStartTime = 0; // Сбрасываем таймер при отпускании
-      }
-    }
-  }
-
-  // Проверяем долгое нажатие, пока кнопка удерживается
-  if (buttonStableState == LOW && !isLongPressHandled && buttonPressStartTime > 0) {
-    if ((now - buttonPressStartTime) >= Config::Input::LONG_PRESS_MS) {
-      longButtonPressedEvent = true;
-      isLongPressHandled = true; // Помечаем, что долгое нажатие обработано
-      Serial.println("Long press detected in updateButton()");
-    }
+// Фронты будят loop() сами, но конец антидребезга и порог долгого
+// нажатия наступают без фронтов - под них взводится ButtonCheck
+void scheduleButtonCheck() {
+  const uint64_t deadline = ButtonInput::nextDeadlineUs();
+  if (deadline != 0) {
+    Scheduler::at(Scheduler::Job::ButtonCheck, deadline);
+  } else {
+    Scheduler::cancel(Scheduler::Job::ButtonCheck);
   }
 }
 
@@ -302,100 +123,90 @@ void updateButton(unsigned long now) {
 // Запуск анимации броска кубиков
 // ----------------------------------------------------------
 
-void startDiceRoll(unsigned long now) {
-  int dice1 = random(1, 7);
-  int dice2 = random(1, 7);
+void startDiceRoll(uint64_t now) {
+  // Бросок прерывает таймер и алерт
+  Scheduler::cancel(Scheduler::Job::TimerSecond);
+  Scheduler::cancel(Scheduler::Job::AlertBlink);
 
-  Serial.print("Dice 1: ");
-  Serial.print(dice1);
-  Serial.print("  Dice 2: ");
-  Serial.println(dice2);
+  uint8_t dice[Config::Dice::COUNT];
+  DiceRng::fill(dice, Config::Dice::COUNT, Config::Dice::FACES);
 
-  if (Config::Animation::CLEAR_SCREEN_ON_START) {
-    tft.fillScreen(Config::Colors::BACKGROUND);
+  for (uint8_t i = 0; i < Config::Dice::COUNT; ++i) {
+    EVENT_LOG(DieValue, i + 1, dice[i]);
   }
 
   // Рисуем рамки кубиков с предыдущими значениями
-  uint16_t initialColor = getColorForSum(lastDice1 + lastDice2);
-  drawDice(Config::Dice::DICE1_X, Config::Dice::DICE1_Y, lastDice1, 0, initialColor, true);
-  drawDice(Config::Dice::DICE2_X, Config::Dice::DICE2_Y, lastDice2, 0, initialColor, true);
+  const uint16_t lastColor = getColorForSum(sumOf(lastDice));
+  for (uint8_t i = 0; i < Config::Dice::COUNT; ++i) {
+    Renderer::rollStart(i, lastDice[i], lastColor);
+  }
 
-  animationCurrentDice1 = lastDice1;
-  animationCurrentDice2 = lastDice2;
-  animationTargetDice1  = dice1;
-  animationTargetDice2  = dice2;
-  animationFrame        = 0;
-  lastFrameTime         = now;
+  // Бросок укладывается в ROLL_DURATION_MS от этого момента при любой нагрузке
+  RollAnimation::start(lastDice, dice, now);
 
   appState = AppState::DiceAnimating;
+  Scheduler::at(Scheduler::Job::AnimationFrame, RollAnimation::nextDeadlineUs());
 }
 
 // ----------------------------------------------------------
 // Запуск таймера
 // ----------------------------------------------------------
 
-void startTimer(unsigned long now) {
-  Serial.println("Starting timer...");
+void startTimer(uint64_t now) {
+  timerStartUs = now;
 
-  timerStartTime     = now;
-  lastSecondUpdate   = now;
-  lastRemainingSeconds = -1; // сброс для полной перерисовки
+  // Итог броска к этому моменту давно на панели, и задача отрисовки
+  // уже сохранила число выводов точек за бросок
+  EVENT_LOG(PipOperations, Renderer::frameStats().rollPipOperations);
 
   appState = AppState::TimerRunning;
 
-  drawTimer(static_cast<int>(Config::Timer::DURATION_SEC), Config::Colors::TimerColor::LEVEL_OK);
+  Renderer::timer(Config::Timer::DURATION_SEC, Config::Colors::TimerColor::LEVEL_OK, true);
+  Scheduler::at(Scheduler::Job::TimerSecond, timerStartUs + Scheduler::msToUs(1000));
 
-  Serial.println("Timer started. Next press will roll dice.");
+  EVENT_LOG(TimerStarted, Config::Timer::DURATION_SEC);
 }
 
 // ----------------------------------------------------------
-// Обработка анимации броска (неблокирующая)
+// Обработка анимации броска (кадр по расписанию)
 // ----------------------------------------------------------
 
-void handleDiceAnimation(unsigned long now) {
-  if (now - lastFrameTime < Config::Animation::FRAME_DELAY_MS) {
-    return;
-  }
-
-  lastFrameTime = now;
-
-  if (animationFrame < Config::Animation::ROLL_FRAMES) {
-    int nextDice1 = random(1, 7);
-    int nextDice2 = random(1, 7);
-
-    // Во время анимации кубики всегда белые
-    uint16_t animColor = Config::Colors::DICE_FILL;
-    // Перерисовываем фон в белый только если он был другого цвета
-    if (animationFrame == 0) {
-        tft.fillRoundRect(Config::Dice::DICE1_X, Config::Dice::DICE1_Y, Config::Dice::SIZE, Config::Dice::SIZE, Config::Dice::RADIUS, animColor);
-        tft.fillRoundRect(Config::Dice::DICE2_X, Config::Dice::DICE2_Y, Config::Dice::SIZE, Config::Dice::SIZE, Config::Dice::RADIUS, animColor);
+void handleDiceAnimation(uint64_t deadlineUs) {
+  const RollAnimation::Step step = RollAnimation::step(deadlineUs, Scheduler::nowUs());
+  if (step != RollAnimation::Step::Finished) {
+    // Щелчок - только с показанным кадром
+    if (step == RollAnimation::Step::Frame) {
+      Audio::play(Audio::beep(Config::Sound::ANIM_TICK_FREQ, Config::Sound::ANIM_TICK_DURATION));
     }
-    drawDice(Config::Dice::DICE1_X, Config::Dice::DICE1_Y, nextDice1, animationCurrentDice1, animColor);
-    drawDice(Config::Dice::DICE2_X, Config::Dice::DICE2_Y, nextDice2, animationCurrentDice2, animColor);
-
-    // Издаем короткий "клик" на каждом кадре
-    tone(Config::Hardware::BUZZER_PIN, Config::Sound::ANIM_TICK_FREQ, Config::Sound::ANIM_TICK_DURATION);
-
-    animationCurrentDice1 = nextDice1;
-    animationCurrentDice2 = nextDice2;
-    ++animationFrame;
+    Scheduler::at(Scheduler::Job::AnimationFrame, RollAnimation::nextDeadlineUs());
   } else {
     // Финальная отрисовка
-    uint16_t finalColor = getColorForSum(animationTargetDice1 + animationTargetDice2);
-    tft.fillRoundRect(Config::Dice::DICE1_X, Config::Dice::DICE1_Y, Config::Dice::SIZE, Config::Dice::SIZE, Config::Dice::RADIUS, finalColor);
-    tft.fillRoundRect(Config::Dice::DICE2_X, Config::Dice::DICE2_Y, Config::Dice::SIZE, Config::Dice::SIZE, Config::Dice::RADIUS, finalColor);
-    drawDice(Config::Dice::DICE1_X, Config::Dice::DICE1_Y, animationTargetDice1, animationCurrentDice1, finalColor);
-    drawDice(Config::Dice::DICE2_X, Config::Dice::DICE2_Y, animationTargetDice2, animationCurrentDice2, finalColor);
+    const uint8_t* target = RollAnimation::target();
+    const uint16_t color = getColorForSum(sumOf(target));
+    for (uint8_t i = 0; i < Config::Dice::COUNT; ++i) {
+      Renderer::rollResult(i, target[i], color);
+      lastDice[i] = target[i];
+    }
 
-    noTone(Config::Hardware::BUZZER_PIN); // Убеждаемся, что звук выключен
+    const RollAnimation::Stats& animation = RollAnimation::stats();
+    EVENT_LOG(RollAnimation, animation.lastFrames, animation.merged, animation.skipped, animation.maxLateUs);
+    EVENT_LOG(RollFrameDraw, Renderer::frameStats().lastUs, Renderer::frameStats().maxUs);
 
-    lastDice1 = animationTargetDice1;
-    lastDice2 = animationTargetDice2;
+    // История копится в RAM; в NVS - пачкой сразу после анимации или в простое
+    // (срок простоя отсчитывается заново с каждым броском). Формат истории - пара d6
+    if constexpr (Config::Dice::COUNT == 2 && Config::Dice::FACES == 6) {
+      RollHistory::record(lastDice[0], lastDice[1]);
+    }
+    Scheduler::at(Scheduler::Job::HistoryFlush,
+                  RollHistory::batchReady()
+                      ? deadlineUs
+                      : deadlineUs + Scheduler::msToUs(Config::History::IDLE_FLUSH_MS));
 
     // Переходим к показу результата на 5 секунд
     appState = AppState::ResultDisplay;
-    resultDisplayStartTime = now;
-    Serial.println("Showing result for 5 seconds, then timer will start automatically.");
+    Scheduler::at(Scheduler::Job::ResultTimeout,
+                  deadlineUs + Scheduler::msToUs(Config::Timer::RESULT_DISPLAY_SEC * 1000UL));
+    EVENT_LOG(ResultShown, Config::Timer::RESULT_DISPLAY_SEC);
   }
 }
 
@@ -403,101 +214,126 @@ void handleDiceAnimation(unsigned long now) {
 // Обработка показа результата броска
 // ----------------------------------------------------------
 
-void handleResultDisplay(unsigned long now) {
-  unsigned long elapsedTime = now - resultDisplayStartTime;
-  
-  // Проверяем, прошло ли 5 секунд
-  if (elapsedTime >= Config::Timer::RESULT_DISPLAY_SEC * 1000UL) {
-    // Автоматически запускаем таймер
-    Serial.println("5 seconds elapsed, starting timer automatically...");
-    startTimer(now);
-  }
+void handleResultDisplay(uint64_t deadlineUs) {
+  // Прошло 5 секунд - автоматически запускаем таймер
+  EVENT_LOG(ResultTimeout);
+  startTimer(deadlineUs);
 }
 
 // ----------------------------------------------------------
 // Обработка таймера
 // ----------------------------------------------------------
 
-void handleTimer(unsigned long now) {
-  unsigned long elapsedTimeSec = (now - timerStartTime) / 1000UL;
+void handleTimer(uint64_t deadlineUs) {
+  // Сроки - ровно timerStartUs + k секунд, поэтому секунды не "уплывают"
+  const uint64_t elapsedUs = deadlineUs - timerStartUs;
+  const uint32_t elapsedTimeSec = static_cast<uint32_t>(elapsedUs / Scheduler::msToUs(1000));
 
   if (elapsedTimeSec >= Config::Timer::DURATION_SEC) {
     // Таймер закончился - включаем алерт
     appState      = AppState::AlertActive;
     alertVisible  = true;
-    lastBlinkTime = now;
+    Scheduler::at(Scheduler::Job::AlertBlink, deadlineUs + Scheduler::msToUs(Config::Alert::BLINK_INTERVAL_MS));
+
+    EVENT_LOG(TimerDrift, elapsedUs - Scheduler::msToUs(Config::Timer::DURATION_SEC * 1000UL),
+              Scheduler::nowUs() - deadlineUs);
 
-    tft.fillScreen(Config::Colors::BACKGROUND);
-    drawAlert(true);
+    Renderer::alert(true, true);
     // Первое срабатывание звука тревоги
-    tone(Config::Hardware::BUZZER_PIN, Config::Sound::ALERT_FREQ, Config::Sound::ALERT_TONE_DURATION);
+    Audio::play(Audio::beep(Config::Sound::ALERT_FREQ, Config::Sound::ALERT_TONE_DURATION));
 
-    Serial.println("Timer finished. Alert mode activated.");
+    EVENT_LOG(AlertStarted);
     return;
   }
 
-  if (now - lastSecondUpdate >= 1000UL) {
-    lastSecondUpdate = now;
-    int remainingSeconds = static_cast<int>(Config::Timer::DURATION_SEC - elapsedTimeSec);
-    uint16_t timerColor;
-    if (remainingSeconds <= 10) {
-      timerColor = Config::Colors::TimerColor::LEVEL_CRITICAL;
-    } else if (remainingSeconds <= 20) {
-      timerColor = Config::Colors::TimerColor::LEVEL_URGENT;
-    } else if (remainingSeconds <= 30) {
-      timerColor = Config::Colors::TimerColor::LEVEL_WARN;
-    } else {
-      timerColor = Config::Colors::TimerColor::LEVEL_OK;
-    }
-    drawTimer(remainingSeconds, timerColor);
-    Serial.print("Timer: ");
-    Serial.println(remainingSeconds);
+  int remainingSeconds = static_cast<int>(Config::Timer::DURATION_SEC - elapsedTimeSec);
+  uint16_t timerColor;
+  if (remainingSeconds <= 10) {
+    timerColor = Config::Colors::TimerColor::LEVEL_CRITICAL;
+  } else if (remainingSeconds <= 20) {
+    timerColor = Config::Colors::TimerColor::LEVEL_URGENT;
+  } else if (remainingSeconds <= 30) {
+    timerColor = Config::Colors::TimerColor::LEVEL_WARN;
+  } else {
+    timerColor = Config::Colors::TimerColor::LEVEL_OK;
   }
+  Renderer::timer(remainingSeconds, timerColor, false);
+  EVENT_LOG(TimerTick, remainingSeconds);
+
+  Scheduler::at(Scheduler::Job::TimerSecond, deadlineUs + Scheduler::msToUs(1000));
 }
 
 // ----------------------------------------------------------
 // Обработка алерта (мигание и звук)
 // ----------------------------------------------------------
 
-void handleAlert(unsigned long now) {
-  if (now - lastBlinkTime > Config::Alert::BLINK_INTERVAL_MS) {
-    lastBlinkTime = now;
-    alertVisible  = !alertVisible;
-    drawAlert(alertVisible);
+void handleAlert(uint64_t deadlineUs) {
+  alertVisible = !alertVisible;
+  Renderer::blink(alertVisible);
 
-    // Издаем звук только когда треугольник видим
-    if (alertVisible) {
-      tone(Config::Hardware::BUZZER_PIN, Config::Sound::ALERT_FREQ, Config::Sound::ALERT_TONE_DURATION);
-    }
+  // Издаем звук только когда треугольник видим
+  if (alertVisible) {
+    Audio::play(Audio::beep(Config::Sound::ALERT_FREQ, Config::Sound::ALERT_TONE_DURATION));
   }
+
+  Scheduler::at(Scheduler::Job::AlertBlink, deadlineUs + Scheduler::msToUs(Config::Alert::BLINK_INTERVAL_MS));
+}
+
+// ----------------------------------------------------------
+// Запись истории бросков в NVS
+// ----------------------------------------------------------
+
+void handleHistoryFlush(uint64_t deadlineUs) {
+  // Запись во flash останавливает кэш - не посреди анимации броска
+  if (appState == AppState::DiceAnimating) {
+    Scheduler::at(Scheduler::Job::HistoryFlush,
+                  deadlineUs + Scheduler::msToUs(Config::Animation::ROLL_DURATION_MS));
+    return;
+  }
+  // Срок простоя пришёлся на показ результата или таймер: игра идёт,
+  // броски ждут пачки
+  if (!RollHistory::batchReady() &&
+      (appState == AppState::ResultDisplay || appState == AppState::TimerRunning)) {
+    Scheduler::at(Scheduler::Job::HistoryFlush, deadlineUs + Scheduler::msToUs(Config::History::IDLE_FLUSH_MS));
+    return;
+  }
+
+  RollHistory::flush();
+  EVENT_LOG(HistorySaved, RollHistory::stats().totalRolls, RollHistory::stats().nvsWrites);
 }
 
 // ----------------------------------------------------------
 // Обработка нажатия кнопки (по событиям)
 // ----------------------------------------------------------
 
-void handleButtonPress(unsigned long now) {
-  // Останавливаем музыку, если она играла
-  if (melodyPlaying) {
-    melodyPlaying = false;
-    noTone(Config::Hardware::BUZZER_PIN);
+void handleButtonPress(const ButtonInput::Event& event, uint64_t now) {
+  ButtonInput::recordLatency(event, now);
+  EVENT_LOG(ButtonGesture, event.gesture, now - event.edgeUs);
+
+  if (event.gesture == ButtonInput::Gesture::LongPress) {
+    EVENT_LOG(LongPress);
+    // Несохранённые броски и счётчики сумм должны пережить перезагрузку
+    RollHistory::flush();
+    EventLog::flush();
+    ESP.restart();
+    return;
   }
-  
-  // Останавливаем любой другой звук перед началом нового действия
-  noTone(Config::Hardware::BUZZER_PIN);
+
+  // Останавливаем музыку и любой другой звук перед началом нового действия
+  Audio::stop();
   // Воспроизводим звук клика
-  tone(Config::Hardware::BUZZER_PIN, Config::Sound::BUTTON_CLICK_FREQ, Config::Sound::BUTTON_CLICK_DURATION);
+  Audio::play(Audio::beep(Config::Sound::BUTTON_CLICK_FREQ, Config::Sound::BUTTON_CLICK_DURATION));
 
   switch (appState) {
     case AppState::DiceRollNext:
-      Serial.println("Manual roll (button pressed)!");
+      EVENT_LOG(ManualRoll);
       startDiceRoll(now);
       break;
 
     case AppState::DiceTimerNext:
       // Deprecated: таймер теперь запускается автоматически после показа результата
       // Но оставляем для совместимости
-      Serial.println("Starting timer (legacy path)...");
+      EVENT_LOG(LegacyTimer);
       startTimer(now);
       break;
 
@@ -506,17 +342,25 @@ void handleButtonPress(unsigned long now) {
       break;
 
     case AppState::ResultDisplay:
+      // Двойной клик запускает таймер, не дожидаясь конца показа результата
+      if (event.gesture == ButtonInput::Gesture::DoubleClick) {
+        EVENT_LOG(DoubleClickTimer);
+        Scheduler::cancel(Scheduler::Job::ResultTimeout);
+        startTimer(now);
+        break;
+      }
       // Во время показа результата игнорируем нажатия - ждем автоматического запуска таймера
-      Serial.println("Please wait, result is being displayed...");
+      EVENT_LOG(ResultBusy);
       break;
 
     case AppState::TimerRunning:
-      Serial.println("Timer interrupted. Rolling dice...");
+      EVENT_LOG(TimerInterrupted);
       startDiceRoll(now);
       break;
 
     case AppState::AlertActive:
-      Serial.println("Alert acknowledged. Rolling dice...");
+      EVENT_LOG(AlertAcknowledged);
+      finishAlert();
       startDiceRoll(now);
       break;
   }
@@ -527,21 +371,7 @@ void handleButtonPress(unsigned long now) {
 // ----------------------------------------------------------
 
 void showIntro() {
-  tft.fillScreen(Config::Colors::BACKGROUND);
-
-  tft.setTextColor(Config::Colors::TITLE_TEXT);
-  tft.setTextSize(Config::Intro::TITLE_TEXT_SIZE);
-  tft.setCursor(Config::Intro::TITLE_DICE_X, Config::Intro::TITLE_DICE_Y);
-  tft.println("DICE");
-  tft.setCursor(Config::Intro::TITLE_ROLLER_X, Config::Intro::TITLE_ROLLER_Y);
-  tft.println("ROLLER");
-
-  tft.setTextColor(Config::Colors::HINT_TEXT);
-  tft.setTextSize(Config::Intro::HINT_TEXT_SIZE);
-  tft.setCursor(Config::Intro::HINT_LINE1_X, Config::Intro::HINT_LINE1_Y);
-  tft.println("Press button");
-  tft.setCursor(Config::Intro::HINT_LINE2_X, Config::Intro::HINT_LINE2_Y);
-  tft.println("to roll!");
+  Renderer::intro();
 
   // Запускаем музыку
   startIntroMelody();
@@ -552,111 +382,154 @@ void showIntro() {
 // ----------------------------------------------------------
 
 void setup() {
+  BootTimeline::mark(BootTimeline::Stage::SetupStart);
+
   Serial.begin(115200);
-  delay(Config::Intro::SERIAL_START_DELAY_MS);
+  if (Config::Boot::FAST_BOOT) {
+    // Ждём USB CDC не дольше SERIAL_WAIT_MAX_MS; UART готов сразу
+    const uint32_t serialStart = millis();
+    while (!Serial && millis() - serialStart < Config::Boot::SERIAL_WAIT_MAX_MS) {
+      delay(1);
+    }
+  } else {
+    delay(Config::Intro::SERIAL_START_DELAY_MS);
+  }
+  BootTimeline::mark(BootTimeline::Stage::SerialPort);
   Serial.println("ESP32 Dice Simulator Starting...");
 
-  pinMode(Config::Hardware::BUTTON_PIN, INPUT_PULLUP);
-  // pinMode для пищалки не требуется, функция tone() сама его настроит
+  // Журнал событий: loop() пишет в кольцо, в Serial выводит своя задача
+  EventLog::begin();
+
+  // Пищалка: канал LEDC и таймер звукового движка
+  Audio::begin(Config::Hardware::BUZZER_PIN);
+  BootTimeline::mark(BootTimeline::Stage::Audio);
 
-  tft.initR(Config::Display::INITR_MODE);
-  delay(Config::Intro::DISPLAY_INIT_DELAY_MS);
+  // Периодические действия - задачи планировщика; loop() спит между ними
+  Scheduler::begin();
+  Scheduler::attach(Scheduler::Job::AnimationFrame, handleDiceAnimation);
+  Scheduler::attach(Scheduler::Job::ResultTimeout,  handleResultDisplay);
+  Scheduler::attach(Scheduler::Job::TimerSecond,    handleTimer);
+  Scheduler::attach(Scheduler::Job::AlertBlink,     handleAlert);
+  Scheduler::attach(Scheduler::Job::HistoryFlush,   handleHistoryFlush);
+  BootTimeline::mark(BootTimeline::Stage::Scheduler);
 
-  tft.setRotation(Config::Display::ROTATION);
+  // Кнопка: вход с подтяжкой и прерывание на оба фронта
+  ButtonInput::begin(Config::Hardware::BUTTON_PIN);
+  BootTimeline::mark(BootTimeline::Stage::Button);
+
+  // Дисплей и задача отрисовки на втором ядре (при быстрой загрузке
+  // панель инициализирует сама задача, параллельно с NVS и RNG)
+  Renderer::begin();
+  BootTimeline::mark(BootTimeline::Stage::RenderTask);
 
   // Инициализация NVS
   preferences.begin("dice-app", false);
+  RollHistory::begin(preferences);
+  Serial.print("Roll history: ");
+  Serial.print(RollHistory::stats().totalRolls);
+  Serial.print(" rolls, NVS writes ");
+  Serial.println(RollHistory::stats().nvsWrites);
   // Так как мелодия всего одна, ее индекс всегда 0
   currentMelodyIndex = 0;
+  BootTimeline::mark(BootTimeline::Stage::Nvs);
 
-  // Инициализация генератора случайных чисел из аппаратного RNG ESP32
-  randomSeed(esp_random());
+  // Генератор бросков засевается из аппаратного RNG ESP32
+  DiceRng::seedFromHardware();
+  BootTimeline::mark(BootTimeline::Stage::Rng);
 
-  tft.fillScreen(Config::Colors::BACKGROUND);
-  delay(Config::Intro::DISPLAY_CLEAR_DELAY_MS);
+  // Интро перекрывает весь экран - очистка перед ним нужна только старому пути
+  if (!Config::Boot::FAST_BOOT) {
+    Renderer::clear(Config::Colors::BACKGROUND);
+    Renderer::present();
+    delay(Config::Intro::DISPLAY_CLEAR_DELAY_MS);
+  }
 
   showIntro();
-  delay(Config::Intro::INTRO_PAUSE_MS);
+  Renderer::present();
+  BootTimeline::mark(BootTimeline::Stage::IntroPosted);
+
+  // Готовность - кадр интро на панели, а не фиксированная пауза
+  if (Config::Boot::FAST_BOOT) {
+    Renderer::waitIdle();
+  } else {
+    delay(Config::Intro::INTRO_PAUSE_MS);
+  }
+
+  // Интро - последний отправленный кадр: его время отрисовки и отправки
+  Serial.print("Intro frame: ");
+  Serial.print(Renderer::frameStats().lastUs);
+  Serial.println(" us");
 
   Serial.println("Display initialized successfully!");
 
   // Начальное состояние: ожидаем бросок кубиков
   appState = AppState::DiceRollNext;
+
+  BootTimeline::mark(BootTimeline::Stage::Ready);
+  if (Config::Boot::REPORT_TIMELINE) {
+    BootTimeline::report(Serial);
+  }
 }
 
 void loop() {
-  unsigned long now = millis();
+  LOOP_TRACE_PASS_BEGIN();
+  const uint64_t now = Scheduler::nowUs();
 
-  // Обновление кнопки и генерация события нажатия
-  updateButton(now);
+  DRAW_PROFILE_STATE(appState);
+  pollDebugCommands();
 
-  // Обработка периодических задач в зависимости от состояния
-  switch (appState) {
-    case AppState::DiceRollNext:
-    case AppState::DiceTimerNext:
-      if (melodyPlaying) {
-        handleIntroMelody(now);
-      }
-      break;
-
-    case AppState::DiceAnimating:
-      handleDiceAnimation(now);
-      break;
+  // Фронты кнопки из прерывания -> антидребезг -> жесты
+  ButtonInput::poll(now);
 
-    case AppState::ResultDisplay:
-      handleResultDisplay(now);
-      break;
-
-    case AppState::TimerRunning:
-      handleTimer(now);
-      break;
-
-    case AppState::AlertActive:
-      handleAlert(now);
-      break;
-  }
+  // Задачи, срок которых наступил (кадры, секунды таймера, мигание)
+  Scheduler::runDue();
 
-  // Обработка события нажатия (если было)
-  if (buttonPressedEvent) {
-    buttonPressedEvent = false;
-    handleButtonPress(now);
+  // Обработка событий кнопки (если были)
+  ButtonInput::Event buttonEvent;
+  while (ButtonInput::nextEvent(buttonEvent)) {
+    LOOP_TRACE_BUTTON(buttonEvent.edgeUs);
+    handleButtonPress(buttonEvent, Scheduler::nowUs());
   }
 
-  if (longButtonPressedEvent) {
-    longButtonPressedEvent = false;
-    Serial.println("Long press detected. Rebooting...");
-    ESP.restart();
-  }
+  // Конец кадра: задача отрисовки отправит на дисплей всё, что поставлено за этот проход
+  Renderer::present();
 
-  delay(Config::Input::LOOP_IDLE_DELAY);
+  // Спим до ближайшей задачи или фронта на кнопке
+  scheduleButtonCheck();
+  LOOP_TRACE_PASS_END();
+  Scheduler::waitForNext(Scheduler::msToUs(Config::Input::MAX_IDLE_SLEEP_MS));
 }
 
 // ----------------------------------------------------------
 // Определение цвета по сумме кубиков
 // ----------------------------------------------------------
 
+int sumOf(const uint8_t* dice) {
+  int sum = 0;
+  for (uint8_t i = 0; i < Config::Dice::COUNT; ++i) {
+    sum += dice[i];
+  }
+  return sum;
+}
+
+// Цвет по удалённости суммы от среднего: для пары d6 это 7 - красный,
+// 6/8 - зелёный ... 2/12 - пурпурный; для других наборов шкала та же
 uint16_t getColorForSum(int sum) {
-  switch (sum) {
-    case 2:
-    case 12:
-      return Config::Colors::DiceSum::SUM_2_12;
-    case 3:
-    case 11:
-      return Config::Colors::DiceSum::SUM_3_11;
-    case 4:
-    case 10:
-      return Config::Colors::DiceSum::SUM_4_10;
-    case 5:
-    case 9:
-      return Config::Colors::DiceSum::SUM_5_9;
-    case 6:
-    case 8:
-      return Config::Colors::DiceSum::SUM_6_8;
-    case 7:
-      return Config::Colors::DiceSum::SUM_7;
-    default:
-      return Config::Colors::DICE_FILL; // Цвет по умолчанию
+  static constexpr uint16_t COLORS[] = {
+    Config::Colors::DiceSum::SUM_7,    Config::Colors::DiceSum::SUM_6_8,
+    Config::Colors::DiceSum::SUM_5_9,  Config::Colors::DiceSum::SUM_4_10,
+    Config::Colors::DiceSum::SUM_3_11, Config::Colors::DiceSum::SUM_2_12
+  };
+  constexpr int LEVELS = sizeof(COLORS) / sizeof(COLORS[0]) - 1;
+  // Расстояния удвоены, чтобы среднее было целым при любом наборе
+  constexpr int MEAN2   = Config::Dice::COUNT * (Config::Dice::FACES + 1);
+  constexpr int SPREAD2 = Config::Dice::COUNT * (Config::Dice::FACES - 1);
+
+  if (sum < Config::Dice::COUNT || sum > Config::Dice::COUNT * Config::Dice::FACES) {
+    return Config::Colors::DICE_FILL; // Цвет по умолчанию
   }
+  const int distance2 = abs(2 * sum - MEAN2);
+  return COLORS[(distance2 * LEVELS + SPREAD2 / 2) / SPREAD2];
 }
 
 // ----------------------------------------------------------
@@ -666,46 +539,12 @@ uint16_t getColorForSum(int sum) {
 void startIntroMelody() {
   // Проверяем, не была ли мелодия уже проиграна
   if (melodyHasPlayed) {
-    Serial.println("Melody already played, skipping...");
-    return;
-  }
-  
-  currentNoteIndex = 0;
-  lastNoteTime     = 0;
-  melodyPlaying    = true;
-  Serial.println("Starting intro melody (one-time play)");
-}
-
-void handleIntroMelody(unsigned long now) {
-  if (!melodyPlaying) {
+    EVENT_LOG(MelodySkipped);
     return;
   }
-
-  // Проверяем, пора ли играть следующую ноту
-  const int* melody = Config::Sound::MELODIES[currentMelodyIndex];
-  int noteCount = Config::Sound::MELODY_NOTE_COUNTS[currentMelodyIndex];
   
-  int currentNoteDuration = static_cast<int>(melody[currentNoteIndex * 2 + 1] * Config::Sound::TEMPO_SCALE);
-  if (now - lastNoteTime > (unsigned long)(currentNoteDuration + Config::Sound::NOTE_PAUSE_BETWEEN)) {
-    lastNoteTime = now;
-
-    // Переходим к следующей ноте
-    currentNoteIndex++;
-    if (currentNoteIndex >= noteCount) {
-      melodyPlaying = false; // Останавливаем воспроизведение после одного раза
-      melodyHasPlayed = true; // Помечаем, что мелодия была проиграна
-      noTone(Config::Hardware::BUZZER_PIN);
-      Serial.println("Intro melody finished, marked as played");
-      return;
-    }
-
-    // Воспроизводим ноту
-    int noteFrequency = melody[currentNoteIndex * 2];
-    int noteDuration = static_cast<int>(melody[currentNoteIndex * 2 + 1] * Config::Sound::TEMPO_SCALE);
-    if (noteFrequency > 0) {
-      tone(Config::Hardware::BUZZER_PIN, noteFrequency, noteDuration);
-    } else {
-      noTone(Config::Hardware::BUZZER_PIN); // Пауза
-    }
-  }
+  // Ноты отсчитывает таймер звукового движка, loop() в этом не участвует
+  Audio::playMelody(Melodies::LIBRARY[currentMelodyIndex % Melodies::COUNT]);
+  melodyHasPlayed = true;
+  EVENT_LOG(MelodyStarted);
 }
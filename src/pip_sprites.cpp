@@ -0,0 +1,82 @@
+#include <Arduino.h>
+
+#include "pip_sprites.h"
+
+// ----------------------------------------------------------
+// Развёртка 1-битных масок в RGB565 и вывод окнами
+// ----------------------------------------------------------
+
+namespace PipSprites {
+
+namespace {
+
+// Буфер под самый крупный спрайт (грань целиком)
+uint16_t spriteBuffer[FACE_SIZE * FACE_SIZE];
+
+uint32_t pipOperations = 0;
+
+template <typename M>
+void expand(const M& mask, uint16_t onColor, uint16_t offColor) {
+  uint16_t* out = spriteBuffer;
+  for (uint16_t y = 0; y < M::HEIGHT; ++y) {
+    for (uint16_t x = 0; x < M::WIDTH; ++x) {
+      *out++ = mask.get(x, y) ? onColor : offColor;
+    }
+  }
+}
+
+} // namespace
+
+void drawPip(RenderTarget& target, int16_t x, int16_t y, uint8_t position, uint16_t pipColor, uint16_t fillColor) {
+  DRAW_PROFILE_PRIMITIVE(Sprite);
+  ++pipOperations;
+  expand(PIP, pipColor, fillColor);
+  target.setAddrWindow(x + POSITION_X[position] - DOT_RADIUS, y + POSITION_Y[position] - DOT_RADIUS,
+                       PIP_SIZE, PIP_SIZE);
+  target.pushPixels(spriteBuffer, PIP_SIZE * PIP_SIZE);
+}
+
+void erasePip(RenderTarget& target, int16_t x, int16_t y, uint8_t position, uint16_t fillColor) {
+  DRAW_PROFILE_PRIMITIVE(Sprite);
+  ++pipOperations;
+  target.setAddrWindow(x + POSITION_X[position] - DOT_RADIUS, y + POSITION_Y[position] - DOT_RADIUS,
+                       PIP_SIZE, PIP_SIZE);
+  target.pushColor(fillColor, PIP_SIZE * PIP_SIZE);
+}
+
+void drawFace(RenderTarget& target, int16_t x, int16_t y, uint8_t value, uint16_t pipColor, uint16_t fillColor) {
+  if (value >= FACE_COUNT) {
+    return;
+  }
+  DRAW_PROFILE_PRIMITIVE(Sprite);
+  ++pipOperations;
+  expand(FACES[value], pipColor, fillColor);
+  target.setAddrWindow(x + FACE_OFFSET, y + FACE_OFFSET, FACE_SIZE, FACE_SIZE);
+  target.pushPixels(spriteBuffer, FACE_SIZE * FACE_SIZE);
+}
+
+void updateFace(RenderTarget& target, int16_t x, int16_t y, uint8_t oldValue, uint8_t value,
+                uint16_t pipColor, uint16_t fillColor) {
+  const uint16_t newMask = faceMask(value);
+  const uint16_t changed = faceMask(oldValue) ^ newMask;
+  for (uint8_t p = 0; p < POSITION_COUNT; ++p) {
+    if (!(changed & (1u << p))) {
+      continue;
+    }
+    if (newMask & (1u << p)) {
+      drawPip(target, x, y, p, pipColor, fillColor);
+    } else {
+      erasePip(target, x, y, p, fillColor);
+    }
+  }
+}
+
+uint32_t pipOperationCount() {
+  return pipOperations;
+}
+
+void resetPipOperationCount() {
+  pipOperations = 0;
+}
+
+} // namespace PipSprites
@@ -0,0 +1,167 @@
+#include <Arduino.h>
+
+#include "reel_strip.h"
+#include "tumble_atlas.h"
+
+// ----------------------------------------------------------
+// Лента барабана и въезжающие столбцы
+// ----------------------------------------------------------
+
+namespace ReelStrip {
+
+namespace {
+
+constexpr int32_t WIDTH = Config::Display::WIDTH;
+constexpr int32_t SIZE  = Config::Dice::SIZE;
+constexpr uint8_t COUNT = Config::Dice::COUNT;
+constexpr uint8_t FACES = Config::Dice::FACES;
+
+// Сетка граней - та же, что у ряда кубиков в раскладке
+constexpr Config::Dice::Spread GRID = Config::Dice::spread(COUNT, WIDTH, SIZE);
+constexpr int16_t              TOP  = Config::Dice::LAYOUT.y[0];
+
+static_assert(!Config::Animation::REEL || GRID.first == Config::Dice::LAYOUT.x[0],
+              "Барабан рассчитан на один ряд кубиков");
+static_assert(DISTANCE % WIDTH == 0, "Итог должен вставать на место при нулевом сдвиге");
+
+// Столбцов за одно окно записи; память - только в режиме барабана
+constexpr uint16_t CHUNK  = 8;
+constexpr uint32_t BUFFER = Config::Animation::REEL ? CHUNK * SIZE : 1;
+
+uint16_t columnBuffer[BUFFER];
+uint8_t  targets[COUNT] = {};
+uint16_t shown          = 0;     // позиция ленты на панели
+bool     scrolling      = false;
+int32_t  windowEnd      = 0;     // начало окна ленты в конце броска (знак - направление)
+
+int32_t floorDiv(int32_t a, int32_t b) {
+  return a / b - ((a % b != 0) && ((a < 0) != (b < 0)) ? 1 : 0);
+}
+
+int32_t wrap(int32_t t) {
+  return t - floorDiv(t, WIDTH) * WIDTH;
+}
+
+// Сторона склейки: начальная сетка (вокруг окна [0, WIDTH)) или итоговая
+bool startSide(int32_t t) {
+  const int32_t splice = windowEnd / 2 + WIDTH / 2;
+  return windowEnd > 0 ? t < splice : t >= splice;
+}
+
+// Грань ленты в столбце t (0 - фон) и столбец внутри грани
+uint8_t faceAt(int32_t t, uint16_t& column) {
+  const bool    start  = startSide(t);
+  const int32_t origin = start ? 0 : windowEnd;
+  const int32_t n      = floorDiv(t - origin - GRID.first, GRID.step);
+  const int32_t cell   = origin + GRID.first + n * GRID.step;
+  column = static_cast<uint16_t>(t - cell);
+  if (t - cell >= SIZE || startSide(cell) != start || startSide(cell + SIZE - 1) != start) {
+    return 0; // зазор между гранями или грань, разрезанная склейкой
+  }
+  if (n >= 0 && n < COUNT) {
+    // Кубики начала ленты уже на панели и обратно не въезжают
+    return start ? 0 : targets[n];
+  }
+  // Окна начала и конца - только кубики, остальная лента вне их
+  if (cell < origin + WIDTH && cell + SIZE > origin) {
+    return 0;
+  }
+  // Перед итогом грани идут по кругу и подходят к нему по порядку
+  const int32_t index = (start ? 0 : targets[0] - 1) + n;
+  return static_cast<uint8_t>(index - floorDiv(index, FACES) * FACES + 1);
+}
+
+// Столбцы ленты [from, to) - в кольцо, окнами по CHUNK столбцов
+void writeColumns(St7735Display& panel, int32_t from, int32_t to) {
+  DRAW_PROFILE_PRIMITIVE(Sprite);
+
+  while (from < to) {
+    const int32_t  line = wrap(from);
+    const uint16_t w    = static_cast<uint16_t>(min<int32_t>(min<int32_t>(to - from, CHUNK), WIDTH - line));
+
+    for (uint16_t i = 0; i < w;) {
+      uint16_t column = 0;
+      const uint8_t value = faceAt(from + i, column);
+      if (value == 0) {
+        for (int32_t y = 0; y < SIZE; ++y) {
+          columnBuffer[y * w + i] = Config::Colors::BACKGROUND;
+        }
+        ++i;
+        continue;
+      }
+      // Остаток грани внутри окна - одним проходом по спрайту
+      const uint16_t span = static_cast<uint16_t>(min<int32_t>(w - i, SIZE - column));
+      TumbleAtlas::columns(value, column, span, Config::Colors::DICE_FILL, Config::Colors::BACKGROUND,
+                           &columnBuffer[i], w);
+      i += span;
+    }
+
+    panel.setAddrWindow(static_cast<uint16_t>(line), TOP, w, SIZE);
+    panel.pushPixels(columnBuffer, static_cast<uint32_t>(w) * SIZE);
+    from += w;
+  }
+}
+
+} // namespace
+
+void reset(St7735Display& panel) {
+  if (scrolling) {
+    panel.scrollTo(0);
+    panel.endScroll();
+  }
+  shown     = 0;
+  scrolling = false;
+}
+
+void setTarget(uint8_t index, uint8_t value) {
+  if (index < COUNT) {
+    targets[index] = value;
+  }
+}
+
+// Кольцо - вся панель: въехавшие столбцы пишутся на место уехавших
+// до сдвига, так что на краю, откуда уходит лента, новый столбец
+// может мелькнуть на время одного прохода развёртки
+void scrollTo(St7735Display& panel, uint16_t position) {
+  if (position > DISTANCE) {
+    position = DISTANCE;
+  }
+  if (position <= shown) {
+    return;
+  }
+
+  // С MY окно ленты едет в сторону меньших столбцов
+  const int32_t sign = panel.scrollMirrored() ? -1 : 1;
+  if (!scrolling) {
+    windowEnd = sign * static_cast<int32_t>(DISTANCE);
+    panel.setScrollArea(0, WIDTH, 0);
+    scrolling = true;
+  }
+
+  if (sign > 0) {
+    writeColumns(panel, shown + WIDTH, position + WIDTH);
+  } else {
+    writeColumns(panel, -static_cast<int32_t>(position), -static_cast<int32_t>(shown));
+  }
+  panel.scrollTo(position % WIDTH);
+  shown = position;
+}
+
+bool finish(St7735Display& panel) {
+  if (!scrolling) {
+    return false;
+  }
+  scrollTo(panel, DISTANCE);
+  panel.endScroll();
+  scrolling = false;
+  return true;
+}
+
+void drawResult(RenderTarget& target) {
+  for (uint8_t i = 0; i < COUNT; ++i) {
+    TumbleAtlas::draw(target, Config::Dice::LAYOUT.x[i], TOP, 0, targets[i], Config::Colors::DICE_FILL,
+                      Config::Colors::BACKGROUND);
+  }
+}
+
+} // namespace ReelStrip
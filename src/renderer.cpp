@@ -0,0 +1,688 @@
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_ST7735.h>
+#include <esp_timer.h>
+
+#include <atomic>
+#if !defined(ESP32)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#include "band_target.h"
+#include "boot_timeline.h"
+#include "config.h"
+#include "die_faces.h"
+#include "draw_profiler.h"
+#include "intro_image.h"
+#if !defined(ESP32)
+#include "mock_tft_bus.h"
+#endif
+#include "pip_sprites.h"
+#include "reel_strip.h"
+#include "renderer.h"
+#include "shadow_framebuffer.h"
+#include "spsc_ring.h"
+#include "st7735_display.h"
+#include "tft_bus.h"
+#include "timer_glyphs.h"
+#include "tumble_atlas.h"
+
+// ----------------------------------------------------------
+// Дисплей: принадлежит задаче отрисовки
+// ----------------------------------------------------------
+
+// Шины дисплея: используется та, что выбрана в Config::Hardware::TFT_BUS
+SoftSpiBus tftSoftBus(
+  Config::Hardware::TFT_CS,
+  Config::Hardware::TFT_DC,
+  Config::Hardware::TFT_MOSI,
+  Config::Hardware::TFT_SCLK,
+  Config::Hardware::TFT_RST
+);
+
+#if defined(ESP32)
+Esp32DmaBus tftDmaBus(
+  Config::Hardware::TFT_CS,
+  Config::Hardware::TFT_DC,
+  Config::Hardware::TFT_MOSI,
+  Config::Hardware::TFT_SCLK,
+  Config::Hardware::TFT_RST,
+  Config::Hardware::TFT_SPI_FREQ_HZ
+);
+#else
+// Хост-сборка [env:native]: вместо VSPI - эмуляция панели в памяти
+MockTftBus tftDmaBus;
+#endif
+
+// Объект дисплея поверх выбранной шины
+// (со сборочным флагом -DDRAW_PROFILER шина оборачивается счётчиками)
+St7735Display tft(DRAW_PROFILE_BUS(
+  Config::Hardware::TFT_BUS == Config::Hardware::TftBusType::VspiDma
+    ? static_cast<TftBus&>(tftDmaBus)
+    : static_cast<TftBus&>(tftSoftBus)
+));
+
+// Теневой кадр и поверхность, в которую идёт отрисовка:
+// либо теневой кадр (см. presentFrame()), либо сразу дисплей,
+// а на время полноэкранного кадра - полоса (см. renderScene())
+ShadowFramebuffer shadowFrame;
+BandTarget        bandTarget;
+RenderTarget*     screen =
+  Config::Display::USE_SHADOW_FRAMEBUFFER
+    ? static_cast<RenderTarget*>(&shadowFrame)
+    : static_cast<RenderTarget*>(&tft);
+
+namespace Renderer {
+
+namespace {
+
+SpscRing<Command, Config::Render::QUEUE_SIZE> commands;
+std::atomic<bool>     busy{false};
+std::atomic<uint32_t> stalls{0};
+bool                  frameDirty = false; // сторона loop(): были команды после present()
+
+// Кадры: поставленные (loop()) и отправленные (задача отрисовки)
+std::atomic<uint32_t> framesPosted{0};
+std::atomic<uint32_t> framesDone{0};
+
+// Время кадров: копится задачей отрисовки, читается loop()
+uint32_t              frameBusyUs = 0;
+std::atomic<uint32_t> frameLastUs{0};
+std::atomic<uint32_t> frameMaxUs{0};
+std::atomic<uint64_t> frameTotalUs{0};
+std::atomic<uint32_t> rollPipOperations{0};
+
+#if !defined(ESP32)
+uint32_t hostFrameCostUs = 0;
+#endif
+
+// Состояние таймера на экране (для частичного обновления)
+int      lastRemainingSeconds = -1;
+uint16_t lastTimerColor       = 0;
+
+// ----------------------------------------------------------
+// Отрисовка кубика
+// ----------------------------------------------------------
+
+void drawDice(int x, int y, int value, int oldValue, uint16_t fillColor, bool isInitialDraw = false) {
+  const uint16_t DICE_SIZE   = Config::Dice::SIZE;
+  const uint16_t DICE_RADIUS = Config::Dice::RADIUS;
+
+  if (isInitialDraw) {
+    screen->fillRoundRect(x, y, DICE_SIZE, DICE_SIZE, DICE_RADIUS, fillColor);
+    screen->drawRoundRect(x, y, DICE_SIZE, DICE_SIZE, DICE_RADIUS, Config::Colors::DICE_BORDER);
+  }
+
+  // Кубик только что залит: вся грань уходит целиком
+  if (isInitialDraw || oldValue <= 0) {
+    DieFaces::draw(*screen, x, y, value, Config::Colors::DICE_PIP, fillColor);
+    return;
+  }
+
+  DieFaces::update(*screen, x, y, oldValue, value, Config::Colors::DICE_PIP, fillColor);
+}
+
+void fillDice(uint8_t index, uint16_t color) {
+  screen->fillRoundRect(Config::Dice::LAYOUT.x[index], Config::Dice::LAYOUT.y[index],
+                       Config::Dice::SIZE, Config::Dice::SIZE, Config::Dice::RADIUS, color);
+}
+
+void clearDiceCorners(uint8_t index) {
+  const int16_t  x    = Config::Dice::LAYOUT.x[index];
+  const int16_t  y    = Config::Dice::LAYOUT.y[index];
+  const int16_t  far  = Config::Dice::SIZE - Config::Dice::RADIUS;
+  const uint16_t side = Config::Dice::RADIUS;
+  screen->fillRect(x, y, side, side, Config::Colors::BACKGROUND);
+  screen->fillRect(x + far, y, side, side, Config::Colors::BACKGROUND);
+  screen->fillRect(x, y + far, side, side, Config::Colors::BACKGROUND);
+  screen->fillRect(x + far, y + far, side, side, Config::Colors::BACKGROUND);
+}
+
+void drawRollStart(const Command& command) {
+  DRAW_PROFILE_HANDLER(DiceRoll);
+
+  if (command.a >= Config::Dice::COUNT) {
+    return;
+  }
+  if (command.a == 0) {
+    if (Config::Animation::CLEAR_SCREEN_ON_START) {
+      screen->fillScreen(Config::Colors::BACKGROUND);
+    }
+    PipSprites::resetPipOperationCount();
+    if constexpr (Config::Animation::REEL) {
+      ReelStrip::reset(tft);
+    }
+  }
+
+  // Рамка кубика с предыдущим значением
+  drawDice(Config::Dice::LAYOUT.x[command.a], Config::Dice::LAYOUT.y[command.a], command.b, 0, command.color, true);
+}
+
+void drawRollFrame(const Command& command) {
+  DRAW_PROFILE_HANDLER(DiceAnimation);
+
+  if (command.a >= Config::Dice::COUNT) {
+    return;
+  }
+
+  // Во время анимации кубики всегда белые
+  const uint16_t animColor = Config::Colors::DICE_FILL;
+
+  // Кувырок: спрайт целиком перекрывает квадрат кубика вместе с фоном
+  if constexpr (Config::Animation::TUMBLE) {
+    TumbleAtlas::draw(*screen, Config::Dice::LAYOUT.x[command.a], Config::Dice::LAYOUT.y[command.a], command.d,
+                      command.b, animColor, Config::Colors::BACKGROUND);
+    return;
+  }
+
+  // Фон перекрашивается только на первом кадре
+  const bool freshFill = (command.flags & FLAG_FULL_REDRAW) != 0;
+  if (freshFill) {
+    fillDice(command.a, animColor);
+  }
+  drawDice(Config::Dice::LAYOUT.x[command.a], Config::Dice::LAYOUT.y[command.a], command.b,
+           freshFill ? 0 : command.c, animColor);
+}
+
+void drawRollResult(const Command& command) {
+  DRAW_PROFILE_HANDLER(DiceAnimation);
+
+  if (command.a >= Config::Dice::COUNT) {
+    return;
+  }
+
+  // Барабан встаёт на итог при нулевом сдвиге; теневой кадр узнаёт, что
+  // лента оставила на панели, и дальше шлёт только отличия от него
+  if constexpr (Config::Animation::REEL) {
+    if (command.a == 0 && ReelStrip::finish(tft) && Config::Display::USE_SHADOW_FRAMEBUFFER) {
+      ReelStrip::drawResult(shadowFrame);
+      shadowFrame.accept();
+    }
+  }
+
+  // После кувырка в углах квадрата, вне скругления, мог остаться спрайт
+  if constexpr (Config::Animation::TUMBLE) {
+    clearDiceCorners(command.a);
+  }
+  fillDice(command.a, command.color);
+  // Заливка уже стёрла старую грань - она рисуется целиком
+  drawDice(Config::Dice::LAYOUT.x[command.a], Config::Dice::LAYOUT.y[command.a], command.b, 0, command.color);
+
+  if (command.a == Config::Dice::COUNT - 1) {
+    rollPipOperations.store(PipSprites::pipOperationCount(), std::memory_order_relaxed);
+  }
+}
+
+// Лента пишется прямо в панель: теневой кадр и полосы её не видят
+void drawReelScroll(const Command& command) {
+  DRAW_PROFILE_HANDLER(DiceAnimation);
+
+  if constexpr (Config::Animation::REEL) {
+    ReelStrip::scrollTo(tft, command.color);
+  }
+}
+
+// ----------------------------------------------------------
+// Отрисовка мигающего алерта
+// ----------------------------------------------------------
+
+void drawAlert(bool visible) {
+  DRAW_PROFILE_HANDLER(Alert);
+
+  if (visible) {
+    const int16_t centerX = Config::Display::WIDTH / 2;
+    const int16_t topY    = Config::Alert::TRI_TOP_Y;
+    const int16_t bottomY = Config::Display::HEIGHT - Config::Alert::TRI_BOTTOM_MARGIN;
+    const int16_t leftX   = Config::Alert::TRI_HORIZONTAL_MARGIN;
+    const int16_t rightX  = Config::Display::WIDTH - Config::Alert::TRI_HORIZONTAL_MARGIN;
+
+    screen->fillTriangle(
+      centerX, topY,
+      leftX,   bottomY,
+      rightX,  bottomY,
+      Config::Colors::ALERT
+    );
+
+    // Знак "!" внутри треугольника
+    screen->fillRect(centerX - 8, 30, 16, 50, Config::Colors::BACKGROUND);
+    screen->fillRect(centerX - 8, 90, 16, 16, Config::Colors::BACKGROUND);
+  } else {
+    // В оригинале при скрытии полностью очищался экран
+    screen->fillScreen(Config::Colors::BACKGROUND);
+  }
+}
+
+// Переключение видимости алерта выбранным в Config::Alert::BLINK_MODE способом
+void blinkAlert(bool visible) {
+  DRAW_PROFILE_HANDLER(Alert);
+
+  switch (Config::Alert::BLINK_MODE) {
+    case Config::Alert::BlinkMode::Redraw:
+      drawAlert(visible);
+      break;
+    case Config::Alert::BlinkMode::DisplayOnOff:
+      tft.enableDisplay(visible);
+      break;
+    case Config::Alert::BlinkMode::Inversion:
+      tft.invertDisplay(!visible);
+      break;
+  }
+}
+
+// ----------------------------------------------------------
+// Отрисовка таймера
+// ----------------------------------------------------------
+
+void drawTimer(int remainingSeconds, uint16_t color) {
+  static_assert(Config::Timer::DURATION_SEC <= 99, "Таймер выводит две цифры");
+  DRAW_PROFILE_HANDLER(Timer);
+
+  // Оптимизация: если и время, и цвет не изменились, выходим
+  if (lastRemainingSeconds == remainingSeconds && lastTimerColor == color) {
+    return;
+  }
+
+  // При первом запуске таймера - очищаем весь экран
+  const bool fullRedraw = (lastRemainingSeconds == -1);
+  if (fullRedraw) {
+    screen->fillScreen(Config::Colors::BACKGROUND);
+  }
+
+  // Та же раскладка, что давал print("%02d") шрифтом размера TEXT_SIZE
+  const int16_t x = (Config::Display::WIDTH  - 2 * TimerGlyphs::CELL_W) / 2;
+  const int16_t y = (Config::Display::HEIGHT - TimerGlyphs::CELL_H) / 2
+                    + Config::Timer::CENTER_Y_OFFSET;
+
+  const uint8_t digits[2] = {
+    static_cast<uint8_t>(remainingSeconds / 10),
+    static_cast<uint8_t>(remainingSeconds % 10)
+  };
+  const uint8_t shown[2] = {
+    static_cast<uint8_t>(lastRemainingSeconds / 10),
+    static_cast<uint8_t>(lastRemainingSeconds % 10)
+  };
+
+  // Перерисовываем только изменившиеся цифры; смена цвета - все цифры
+  for (uint8_t i = 0; i < 2; ++i) {
+    if (fullRedraw || color != lastTimerColor || digits[i] != shown[i]) {
+      TimerGlyphs::drawDigit(*screen, x + i * TimerGlyphs::CELL_W, y, digits[i], color,
+                             Config::Colors::BACKGROUND);
+    }
+  }
+
+  lastRemainingSeconds = remainingSeconds;
+  lastTimerColor       = color;
+}
+
+// ----------------------------------------------------------
+// Интро-экран
+// ----------------------------------------------------------
+
+// Картинка собрана при компиляции (intro_image.h) и перекрывает весь экран
+void drawIntro() {
+  DRAW_PROFILE_HANDLER(Intro);
+
+  IntroImage::draw(*screen);
+}
+
+// ----------------------------------------------------------
+// Вывод теневого кадра на дисплей
+// ----------------------------------------------------------
+
+void presentFrame() {
+  DRAW_PROFILE_FRAME();
+
+  if (Config::Display::USE_SHADOW_FRAMEBUFFER) {
+    shadowFrame.flush(tft);
+  }
+}
+
+// ----------------------------------------------------------
+// Исполнение команд
+// ----------------------------------------------------------
+
+void apply(const Command& command) {
+  switch (command.op) {
+    case Op::Clear:
+      screen->fillScreen(command.color);
+      break;
+    case Op::Intro:
+      drawIntro();
+      break;
+    case Op::RollStart:
+      drawRollStart(command);
+      break;
+    case Op::RollFrame:
+      drawRollFrame(command);
+      break;
+    case Op::RollResult:
+      drawRollResult(command);
+      break;
+    case Op::Timer:
+      if (command.flags & FLAG_FULL_REDRAW) {
+        lastRemainingSeconds = -1; // сброс для полной перерисовки
+      }
+      drawTimer(command.a, command.color);
+      break;
+    case Op::Alert:
+      if (command.flags & FLAG_FULL_REDRAW) {
+        screen->fillScreen(Config::Colors::BACKGROUND);
+      }
+      drawAlert(command.a != 0);
+      break;
+    case Op::Blink:
+      blinkAlert(command.a != 0);
+      break;
+    case Op::ReelTarget:
+      ReelStrip::setTarget(command.a, command.b);
+      break;
+    case Op::ReelScroll:
+      drawReelScroll(command);
+      break;
+    case Op::Present:
+      presentFrame();
+      break;
+  }
+}
+
+// ----------------------------------------------------------
+// Полноэкранные кадры полосами (Config::Display::BANDED)
+// ----------------------------------------------------------
+
+// Команда перекрывает весь экран: всё, что рисовалось до неё, не видно.
+// Интро не в списке: картинка и так уходит одним окном со скоростью шины
+bool coversScreen(const Command& command) {
+  const bool full = (command.flags & FLAG_FULL_REDRAW) != 0;
+  switch (command.op) {
+    case Op::Clear:
+      return true;
+    case Op::RollStart:
+      return command.a == 0 && Config::Animation::CLEAR_SCREEN_ON_START;
+    case Op::Timer:
+      return full;
+    case Op::Alert:
+      return full || command.a == 0;
+    case Op::Blink:
+      return Config::Alert::BLINK_MODE == Config::Alert::BlinkMode::Redraw && command.a == 0;
+    default:
+      return false;
+  }
+}
+
+// Команды кадра с начала полноэкранной команды до present()
+Command scene[Config::Render::QUEUE_SIZE];
+uint8_t sceneLength = 0;
+
+// Сцена прогоняется по разу на полосу. Состояние таймера на экране
+// восстанавливается перед каждым прогоном, чтобы все полосы видели
+// один и тот же кадр
+void renderScene() {
+  const int      seconds = lastRemainingSeconds;
+  const uint16_t color   = lastTimerColor;
+  for (uint8_t band = 0; band < BandTarget::COUNT; ++band) {
+    lastRemainingSeconds = seconds;
+    lastTimerColor       = color;
+    bandTarget.beginBand(tft, band);
+    screen = &bandTarget;
+    for (uint8_t i = 0; i < sceneLength; ++i) {
+      apply(scene[i]);
+    }
+    screen = &tft;
+    // Байты полосы - обработчику, который её рисовал
+    DRAW_PROFILE_FRAME();
+    bandTarget.sendBand(tft);
+  }
+  sceneLength = 0;
+}
+
+void execute(const Command& command) {
+  if constexpr (Config::Display::BANDED) {
+    if (sceneLength > 0 || coversScreen(command)) {
+      // Мигание командами панели не рисует пикселей - сразу
+      if (command.op == Op::Blink && !coversScreen(command)) {
+        apply(command);
+        return;
+      }
+      if (command.op == Op::Present) {
+        renderScene();
+        apply(command);
+        return;
+      }
+      // Сцена не помещается - остаток кадра рисуется прямо на панель
+      if (sceneLength == Config::Render::QUEUE_SIZE) {
+        renderScene();
+        apply(command);
+        return;
+      }
+      scene[sceneLength++] = command;
+      return;
+    }
+  }
+  apply(command);
+}
+
+#if !defined(ESP32)
+bool hostThreaded = false;
+#endif
+
+// Часы для замера кадров. Хост с отдельным потоком: виртуальное время
+// двигает loop(), а не отрисовка, - замер там ничего не значит
+uint64_t frameClockUs() {
+#if !defined(ESP32)
+  if (hostThreaded) {
+    return 0;
+  }
+#endif
+  return esp_timer_get_time();
+}
+
+// Исполнить команду и учесть её время в кадре
+void executeTimed(const Command& command) {
+  const uint64_t startUs = frameClockUs();
+  execute(command);
+#if !defined(ESP32)
+  if (command.op == Op::Present && hostFrameCostUs > 0 && !hostThreaded) {
+    VirtualClock::advanceUs(hostFrameCostUs);
+  }
+#endif
+  frameBusyUs += static_cast<uint32_t>(frameClockUs() - startUs);
+
+  if (command.op == Op::Present) {
+    frameLastUs.store(frameBusyUs, std::memory_order_relaxed);
+    if (frameBusyUs > frameMaxUs.load(std::memory_order_relaxed)) {
+      frameMaxUs.store(frameBusyUs, std::memory_order_relaxed);
+    }
+    frameTotalUs.fetch_add(frameBusyUs, std::memory_order_relaxed);
+    frameBusyUs = 0;
+    BootTimeline::mark(BootTimeline::Stage::FirstFrame);
+    framesDone.fetch_add(1, std::memory_order_release);
+  }
+}
+
+// Выполнить всё, что есть в кольце (вызывается только потребителем)
+void drain() {
+  busy.store(true, std::memory_order_release);
+  Command command;
+  while (commands.pop(command)) {
+    executeTimed(command);
+  }
+  busy.store(false, std::memory_order_release);
+}
+
+bool idle() {
+  return commands.empty() && !busy.load(std::memory_order_acquire);
+}
+
+// Панель: сброс, команды инициализации, поворот
+void initPanel() {
+  tft.initR(Config::Display::INITR_MODE);
+  if (!Config::Boot::FAST_BOOT) {
+    delay(Config::Intro::DISPLAY_INIT_DELAY_MS);
+  }
+
+  tft.setRotation(Config::Display::ROTATION);
+  BootTimeline::mark(BootTimeline::Stage::PanelReady);
+}
+
+#if defined(ESP32)
+TaskHandle_t renderTask = nullptr;
+
+void renderTaskMain(void*) {
+  // Быстрая загрузка: задержки сброса панели идут здесь, пока setup() открывает NVS
+  if (Config::Boot::FAST_BOOT) {
+    initPanel();
+  }
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    drain();
+  }
+}
+
+void wakeConsumer() {
+  xTaskNotifyGive(renderTask);
+}
+
+void waitForRoom() {
+  vTaskDelay(1);
+}
+#else
+std::thread             hostThread;
+std::mutex              hostMutex;
+std::condition_variable hostWake;
+bool                    hostPending  = false;
+bool                    hostStop     = false;
+
+void hostThreadMain() {
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(hostMutex);
+      hostWake.wait(lock, [] { return hostPending || hostStop; });
+      if (hostStop && !hostPending) {
+        return;
+      }
+      hostPending = false;
+    }
+    drain();
+  }
+}
+
+void wakeConsumer() {
+  if (!hostThreaded) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(hostMutex);
+    hostPending = true;
+  }
+  hostWake.notify_one();
+}
+
+void waitForRoom() {
+  if (hostThreaded) {
+    std::this_thread::yield();
+  } else {
+    drain();
+  }
+}
+#endif
+
+} // namespace
+
+void begin() {
+#if defined(ESP32)
+  if (!Config::Boot::FAST_BOOT) {
+    initPanel();
+  }
+  xTaskCreatePinnedToCore(renderTaskMain, "render", Config::Render::TASK_STACK, nullptr,
+                          Config::Render::TASK_PRIORITY, &renderTask, Config::Render::TASK_CORE);
+#else
+  // Хост: delay() двигает общие виртуальные часы - панель всегда из loop()
+  initPanel();
+  if (hostThreaded && !hostThread.joinable()) {
+    hostStop   = false;
+    hostThread = std::thread(hostThreadMain);
+  }
+#endif
+}
+
+void post(const Command& command) {
+  frameDirty = (command.op != Op::Present);
+  // Кольцо полно - отрисовка отстаёт; ждём места, но не SPI
+  while (!commands.push(command)) {
+    stalls.fetch_add(1, std::memory_order_relaxed);
+    wakeConsumer();
+    waitForRoom();
+  }
+#if !defined(ESP32)
+  // Синхронный режим хоста: кадр рисуется целиком на present()
+  if (!hostThreaded) {
+    if (command.op == Op::Present) {
+      drain();
+    }
+    return;
+  }
+#endif
+  wakeConsumer();
+}
+
+void present() {
+  if (frameDirty) {
+    framesPosted.fetch_add(1, std::memory_order_relaxed);
+    post({Op::Present, 0, 0, 0, 0, 0, 0});
+  }
+}
+
+void waitIdle() {
+#if defined(ESP32)
+  while (!idle()) {
+    wakeConsumer();
+    delay(1);
+  }
+#else
+  if (!hostThreaded) {
+    drain();
+    return;
+  }
+  while (!idle()) {
+    wakeConsumer();
+    std::this_thread::yield();
+  }
+#endif
+}
+
+uint32_t stallCount() {
+  return stalls.load(std::memory_order_relaxed);
+}
+
+FrameStats frameStats() {
+  return {framesDone.load(std::memory_order_acquire), frameLastUs.load(std::memory_order_relaxed),
+          frameMaxUs.load(std::memory_order_relaxed), frameTotalUs.load(std::memory_order_relaxed),
+          rollPipOperations.load(std::memory_order_relaxed)};
+}
+
+uint32_t pendingFrames() {
+  return framesPosted.load(std::memory_order_relaxed) - framesDone.load(std::memory_order_acquire);
+}
+
+#if !defined(ESP32)
+void setHostThreaded(bool threaded) {
+  if (!threaded && hostThread.joinable()) {
+    waitIdle();
+    {
+      std::lock_guard<std::mutex> lock(hostMutex);
+      hostStop = true;
+    }
+    hostWake.notify_one();
+    hostThread.join();
+  }
+  hostThreaded = threaded;
+}
+
+void setHostFrameCostUs(uint32_t costUs) {
+  hostFrameCostUs = costUs;
+}
+#endif
+
+} // namespace Renderer
@@ -0,0 +1,153 @@
+#include <Arduino.h>
+#include <Adafruit_ST7735.h>
+
+#include "dice_rng.h"
+#include "reel_strip.h"
+#include "renderer.h"
+#include "roll_animation.h"
+#include "tumble_atlas.h"
+
+// ----------------------------------------------------------
+// Расписание кадров по кривой и догоняющий шаг
+// ----------------------------------------------------------
+
+namespace RollAnimation {
+
+namespace {
+
+// Шагов расписания: промежуточные кадры и итог (шаг STEPS)
+constexpr uint32_t STEPS       = Config::Animation::ROLL_FRAMES + 1;
+constexpr uint32_t SPAN        = STEPS - 1;
+constexpr uint64_t DURATION_US = Config::Animation::ROLL_DURATION_MS * 1000ULL;
+constexpr uint32_t EASE        = Config::Animation::EASE_OUT_PERCENT;
+
+// Первый кадр - как раньше, через FRAME_DELAY_MS (щелчок кнопки успевает
+// отзвучать); по кривой распределяется остаток бюджета
+constexpr uint64_t LEAD_US = Config::Animation::FRAME_DELAY_MS * 1000ULL;
+
+static_assert(EASE <= 100, "EASE_OUT_PERCENT - от 0 до 100");
+
+uint64_t startUs    = 0;
+uint8_t  nextStep   = 1;    // ближайший ещё не показанный шаг
+bool     filled     = false; // первый показанный кадр перекрашивает кубики
+uint8_t  angle      = 0;     // угол кувырка, шагов по 90 / ANGLE_COUNT градусов
+uint8_t  shownFaces[Config::Dice::COUNT]  = {};
+uint8_t  targetFaces[Config::Dice::COUNT] = {};
+Stats    current    = {};
+
+// Промежуточные грани - из своего генератора: число кадров зависит от
+// скорости отрисовки, а общий поток DiceRng (итоги бросков) - не должен.
+// Засев - из номера броска и итога, так что общий поток не трогается вовсе
+DiceRng::Generator tumbleFaces;
+
+// Момент шага k >= 1 от начала броска: LEAD + остаток * (x + e * (x^2 - x)),
+// x = (k - 1) / SPAN
+constexpr uint64_t offsetUs(uint32_t k) {
+  const uint64_t j      = k - 1;
+  const uint64_t linear = 100ULL * j * SPAN;
+  const uint64_t bend   = static_cast<uint64_t>(EASE) * j * (SPAN - j);
+  return LEAD_US + (DURATION_US - LEAD_US) * (linear - bend) / (100ULL * SPAN * SPAN);
+}
+
+static_assert(STEPS >= 3 && DURATION_US > LEAD_US, "Бюджет броска меньше первого кадра");
+static_assert(offsetUs(1) == LEAD_US && offsetUs(STEPS) == DURATION_US,
+              "Первый кадр через FRAME_DELAY_MS, итог - ровно в конце бюджета");
+static_assert(EASE == 0 || offsetUs(3) - offsetUs(2) > offsetUs(2) - offsetUs(1), "Шаги должны расти к концу");
+// Кувырок смотрится плавно только от 30 кадров в секунду: самый длинный шаг - последний
+static_assert(!Config::Animation::TUMBLE || offsetUs(STEPS) - offsetUs(STEPS - 1) <= 1000000 / 30,
+              "Кувырок медленнее 30 кадров в секунду: уменьшите FRAME_DELAY_MS или EASE_OUT_PERCENT");
+
+// Позиция ленты барабана к шагу k: путь по времени шага с замедлением,
+// p = DISTANCE * x * (2 - x), x = t / D
+constexpr uint16_t reelPosition(uint32_t k) {
+  const uint64_t t = offsetUs(k);
+  return static_cast<uint16_t>(ReelStrip::DISTANCE * t * (2 * DURATION_US - t) / (DURATION_US * DURATION_US));
+}
+
+static_assert(reelPosition(STEPS) == ReelStrip::DISTANCE, "Лента должна доезжать до итога");
+
+} // namespace
+
+void start(const uint8_t* shown, const uint8_t* target, uint64_t now) {
+  startUs  = now;
+  nextStep = 1;
+  filled   = false;
+  angle    = 0;
+  for (uint8_t i = 0; i < Config::Dice::COUNT; ++i) {
+    shownFaces[i]  = shown[i];
+    targetFaces[i] = target[i];
+  }
+  ++current.rolls;
+  current.lastFrames = 0;
+
+  uint64_t key = current.rolls;
+  for (uint8_t i = 0; i < Config::Dice::COUNT; ++i) {
+    key = key * 256 + target[i];
+  }
+  tumbleFaces.seed(key);
+
+  if constexpr (Config::Animation::REEL) {
+    for (uint8_t i = 0; i < Config::Dice::COUNT; ++i) {
+      Renderer::reelTarget(i, target[i]);
+    }
+  }
+}
+
+uint64_t nextDeadlineUs() {
+  return startUs + offsetUs(nextStep);
+}
+
+Step step(uint64_t deadlineUs, uint64_t nowUs) {
+  if (nowUs > deadlineUs && nowUs - deadlineUs > current.maxLateUs) {
+    current.maxLateUs = static_cast<uint32_t>(nowUs - deadlineUs);
+  }
+
+  // Опоздавшие шаги сливаются в последний наступивший
+  uint8_t due = nextStep;
+  while (due < STEPS && startUs + offsetUs(due + 1) <= nowUs) {
+    ++due;
+  }
+  current.merged += due - nextStep;
+  nextStep = static_cast<uint8_t>(due + 1);
+
+  if (due >= STEPS) {
+    return Step::Finished;
+  }
+
+  // Прошлый кадр ещё не на панели - новый только удлинил бы очередь
+  if (Renderer::pendingFrames() > 0) {
+    ++current.skipped;
+    return Step::Skipped;
+  }
+
+  // Барабан: кадр - только сдвиг ленты, грани на ней уже расставлены
+  if constexpr (Config::Animation::REEL) {
+    Renderer::reelScroll(reelPosition(due));
+  } else {
+    // Кубик поворачивается на шаг за каждый показанный кадр; нечётные катятся навстречу
+    angle = static_cast<uint8_t>((angle + 1) % TumbleAtlas::ANGLE_COUNT);
+
+    uint8_t faces[Config::Dice::COUNT];
+    tumbleFaces.fill(faces, Config::Dice::COUNT, Config::Dice::FACES);
+    for (uint8_t i = 0; i < Config::Dice::COUNT; ++i) {
+      const uint8_t dieAngle =
+          (i & 1) ? static_cast<uint8_t>((TumbleAtlas::ANGLE_COUNT - angle) % TumbleAtlas::ANGLE_COUNT) : angle;
+      Renderer::rollFrame(i, shownFaces[i], faces[i], dieAngle, !filled);
+      shownFaces[i] = faces[i];
+    }
+  }
+  filled = true;
+  ++current.frames;
+  ++current.lastFrames;
+  return Step::Frame;
+}
+
+const uint8_t* target() {
+  return targetFaces;
+}
+
+const Stats& stats() {
+  return current;
+}
+
+} // namespace RollAnimation
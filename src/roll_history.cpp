@@ -0,0 +1,152 @@
+#include <Arduino.h>
+#include <Adafruit_ST7735.h>
+#include <Preferences.h>
+
+#include "config.h"
+#include "roll_history.h"
+
+// ----------------------------------------------------------
+// Кольцо по 6 бит + счётчики сумм -> один блоб в NVS
+// ----------------------------------------------------------
+
+namespace RollHistory {
+
+namespace {
+
+constexpr uint16_t CAPACITY     = Config::History::CAPACITY;
+constexpr uint8_t  BITS         = 6;
+constexpr uint8_t  MASK         = (1u << BITS) - 1;
+constexpr uint8_t  SUM_COUNT    = 11; // суммы 2..12
+constexpr uint8_t  BLOB_VERSION = 1;
+constexpr uint16_t RING_BYTES   = CAPACITY * BITS / 8;
+
+static_assert(CAPACITY % 4 == 0, "4 броска по 6 бит - ровно 3 байта");
+
+// Всё, что переживает перезагрузку; пишется целиком одной операцией
+struct Blob {
+  uint8_t  version;
+  uint8_t  reserved;
+  uint16_t head;      // индекс следующей записи в кольце
+  uint16_t count;     // заполнено ячеек кольца
+  uint16_t reserved2;
+  uint32_t nvsWrites;
+  uint32_t nvsBytes;
+  uint32_t totalRolls;
+  uint32_t sums[SUM_COUNT];
+  uint8_t  ring[RING_BYTES];
+};
+
+Preferences* nvs = nullptr;
+Blob         blob = {};
+Stats        current = {};
+
+void setPacked(uint16_t index, uint8_t value) {
+  const uint16_t bit   = index * BITS;
+  const uint16_t byte  = bit / 8;
+  const uint8_t  shift = bit % 8;
+  uint16_t window = blob.ring[byte];
+  if (byte + 1 < RING_BYTES) {
+    window |= blob.ring[byte + 1] << 8;
+  }
+  window = (window & ~(MASK << shift)) | ((value & MASK) << shift);
+  blob.ring[byte] = static_cast<uint8_t>(window);
+  if (byte + 1 < RING_BYTES) {
+    blob.ring[byte + 1] = static_cast<uint8_t>(window >> 8);
+  }
+}
+
+uint8_t getPacked(uint16_t index) {
+  const uint16_t bit   = index * BITS;
+  const uint16_t byte  = bit / 8;
+  const uint8_t  shift = bit % 8;
+  uint16_t window = blob.ring[byte];
+  if (byte + 1 < RING_BYTES) {
+    window |= blob.ring[byte + 1] << 8;
+  }
+  return (window >> shift) & MASK;
+}
+
+void syncStats() {
+  current.totalRolls = blob.totalRolls;
+  current.nvsWrites  = blob.nvsWrites;
+  current.nvsBytes   = blob.nvsBytes;
+}
+
+} // namespace
+
+void begin(Preferences& preferences) {
+  nvs = &preferences;
+  blob = {};
+  if (nvs->getBytesLength(Config::History::NVS_KEY) == sizeof(Blob)) {
+    nvs->getBytes(Config::History::NVS_KEY, &blob, sizeof(Blob));
+  }
+  if (blob.version != BLOB_VERSION || blob.head >= CAPACITY || blob.count > CAPACITY) {
+    // Нет записи или другой формат - начинаем заново
+    blob = {};
+    blob.version = BLOB_VERSION;
+  }
+  current.pending = 0;
+  syncStats();
+}
+
+void record(uint8_t dice1, uint8_t dice2) {
+  if (dice1 < 1 || dice1 > 6 || dice2 < 1 || dice2 > 6) {
+    return;
+  }
+  setPacked(blob.head, (dice1 - 1) * 6 + (dice2 - 1));
+  blob.head = (blob.head + 1) % CAPACITY;
+  if (blob.count < CAPACITY) {
+    ++blob.count;
+  }
+  ++blob.sums[dice1 + dice2 - 2];
+  ++blob.totalRolls;
+  ++current.pending;
+  syncStats();
+}
+
+uint16_t size() {
+  return blob.count;
+}
+
+bool recent(uint16_t age, uint8_t& dice1, uint8_t& dice2) {
+  if (age >= blob.count) {
+    return false;
+  }
+  const uint8_t packed = getPacked((blob.head + CAPACITY - 1 - age) % CAPACITY);
+  dice1 = packed / 6 + 1;
+  dice2 = packed % 6 + 1;
+  return true;
+}
+
+uint32_t sumCount(uint8_t sum) {
+  if (sum < 2 || sum > 12) {
+    return 0;
+  }
+  return blob.sums[sum - 2];
+}
+
+bool batchReady() {
+  return current.pending >= Config::History::FLUSH_BATCH;
+}
+
+void flush() {
+  if (nvs == nullptr || current.pending == 0) {
+    return;
+  }
+  // Учёт износа едет в том же блобе: отдельного ключа не пишем
+  ++blob.nvsWrites;
+  blob.nvsBytes += sizeof(Blob);
+  if (nvs->putBytes(Config::History::NVS_KEY, &blob, sizeof(Blob)) != sizeof(Blob)) {
+    --blob.nvsWrites;
+    blob.nvsBytes -= sizeof(Blob);
+    return;
+  }
+  current.pending = 0;
+  syncStats();
+}
+
+const Stats& stats() {
+  return current;
+}
+
+} // namespace RollHistory
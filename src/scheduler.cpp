@@ -0,0 +1,153 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+
+#include "loop_trace.h"
+#include "scheduler.h"
+
+// ----------------------------------------------------------
+// Слоты задач
+// ----------------------------------------------------------
+
+namespace Scheduler {
+
+namespace {
+
+constexpr uint8_t JOB_COUNT = static_cast<uint8_t>(Job::COUNT);
+
+struct Slot {
+  Callback callback;
+  uint64_t deadlineUs;
+  bool     armed;
+};
+
+Slot slots[JOB_COUNT];
+
+// Ближайшая взведённая задача; JOB_COUNT - если нет ни одной
+uint8_t earliest() {
+  uint8_t best = JOB_COUNT;
+  for (uint8_t i = 0; i < JOB_COUNT; ++i) {
+    if (slots[i].armed && (best == JOB_COUNT || slots[i].deadlineUs < slots[best].deadlineUs)) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+#if defined(ESP32)
+// Таймер пробуждения будит задачу loop() уведомлением FreeRTOS
+TaskHandle_t       loopTask  = nullptr;
+esp_timer_handle_t wakeTimer = nullptr;
+
+void onWakeTimer(void*) {
+  xTaskNotifyGive(loopTask);
+}
+#else
+volatile bool wakeRequested = false;
+uint64_t      hostWakeLimit = UINT64_MAX;
+#endif
+
+} // namespace
+
+uint64_t nowUs() {
+  return static_cast<uint64_t>(esp_timer_get_time());
+}
+
+void begin() {
+#if defined(ESP32)
+  loopTask = xTaskGetCurrentTaskHandle();
+  if (wakeTimer == nullptr) {
+    esp_timer_create_args_t args = {};
+    args.callback = onWakeTimer;
+    args.name     = "loop-wake";
+    ESP_ERROR_CHECK(esp_timer_create(&args, &wakeTimer));
+  }
+#endif
+}
+
+void attach(Job job, Callback callback) {
+  slots[static_cast<uint8_t>(job)].callback = callback;
+}
+
+void at(Job job, uint64_t deadlineUs) {
+  Slot& slot = slots[static_cast<uint8_t>(job)];
+  slot.deadlineUs = deadlineUs;
+  slot.armed      = true;
+}
+
+void cancel(Job job) {
+  slots[static_cast<uint8_t>(job)].armed = false;
+}
+
+bool pending(Job job) {
+  return slots[static_cast<uint8_t>(job)].armed;
+}
+
+void runDue() {
+  for (;;) {
+    const uint8_t next = earliest();
+    if (next == JOB_COUNT || slots[next].deadlineUs > nowUs()) {
+      return;
+    }
+    Slot& slot = slots[next];
+    slot.armed = false;
+    LOOP_TRACE_JOB(static_cast<Job>(next), slot.deadlineUs);
+    if (slot.callback != nullptr) {
+      slot.callback(slot.deadlineUs);
+    }
+  }
+}
+
+void waitForNext(uint64_t maxSleepUs) {
+  const uint64_t now = nowUs();
+  uint64_t wakeAt = now + maxSleepUs;
+  const uint8_t next = earliest();
+  if (next != JOB_COUNT && slots[next].deadlineUs < wakeAt) {
+    wakeAt = slots[next].deadlineUs;
+  }
+  LOOP_TRACE_WAKE(wakeAt);
+
+#if defined(ESP32)
+  if (wakeAt <= now) {
+    return;
+  }
+  esp_timer_stop(wakeTimer);
+  ESP_ERROR_CHECK(esp_timer_start_once(wakeTimer, wakeAt - now));
+  // Уведомление приходит от таймера или из ISR кнопки; если ISR сработал
+  // во время обработки, уведомление уже ожидает и сна не будет
+  ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  esp_timer_stop(wakeTimer);
+#else
+  if (wakeRequested) {
+    wakeRequested = false;
+    return;
+  }
+  if (wakeAt > hostWakeLimit) {
+    wakeAt = hostWakeLimit;
+  }
+  if (wakeAt > now) {
+    VirtualClock::setUs(wakeAt);
+  }
+#endif
+}
+
+void IRAM_ATTR wakeFromIsr() {
+#if defined(ESP32)
+  BaseType_t woken = pdFALSE;
+  if (loopTask != nullptr) {
+    vTaskNotifyGiveFromISR(loopTask, &woken);
+  }
+  if (woken == pdTRUE) {
+    portYIELD_FROM_ISR();
+  }
+#else
+  wakeRequested = true;
+#endif
+}
+
+#if !defined(ESP32)
+void setHostWakeLimit(uint64_t us) {
+  hostWakeLimit = us;
+}
+#endif
+
+} // namespace Scheduler
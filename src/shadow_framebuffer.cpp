@@ -0,0 +1,296 @@
+#include <Arduino.h>
+
+#include "shadow_framebuffer.h"
+
+// ----------------------------------------------------------
+// Теневой кадр: запись индексов палитры
+// ----------------------------------------------------------
+
+ShadowFramebuffer::ShadowFramebuffer() : RenderTarget(WIDTH, HEIGHT) {
+  memset(frame, 0, sizeof(frame));
+  invalidate();
+}
+
+uint8_t ShadowFramebuffer::colorIndex(uint16_t color) {
+  // Подряд обычно идут примитивы одного цвета
+  static uint16_t lastColor = ShadowPalette::TABLE.colors[0];
+  static uint8_t  lastIndex = 0;
+  if (color == lastColor) {
+    return lastIndex;
+  }
+
+  // Точное совпадение, иначе ближайший цвет палитры
+  uint8_t best = 0;
+  uint32_t bestDistance = UINT32_MAX;
+  for (uint8_t i = 0; i < ShadowPalette::TABLE.size; ++i) {
+    const uint16_t candidate = ShadowPalette::TABLE.colors[i];
+    const int32_t dr = static_cast<int32_t>(color >> 11) - (candidate >> 11);
+    const int32_t dg = static_cast<int32_t>((color >> 5) & 0x3F) - ((candidate >> 5) & 0x3F);
+    const int32_t db = static_cast<int32_t>(color & 0x1F) - (candidate & 0x1F);
+    const uint32_t distance = static_cast<uint32_t>(4 * dr * dr + dg * dg + 4 * db * db);
+    if (distance < bestDistance) {
+      bestDistance = distance;
+      best = i;
+      if (distance == 0) {
+        break;
+      }
+    }
+  }
+
+  lastColor = color;
+  lastIndex = best;
+  return best;
+}
+
+void ShadowFramebuffer::markChanged(int16_t y, uint32_t chunks) {
+  dirtyChunks[y] |= chunks;
+  if (y < dirtyMin) {
+    dirtyMin = y;
+  }
+  if (y > dirtyMax) {
+    dirtyMax = y;
+  }
+}
+
+void ShadowFramebuffer::setIndex(int16_t x, int16_t y, uint8_t index) {
+  uint8_t& cell = frame[y * ROW_BYTES + x / 2];
+  const uint8_t value = (x & 1) ? static_cast<uint8_t>((cell & 0x0F) | (index << 4))
+                                : static_cast<uint8_t>((cell & 0xF0) | index);
+  if (value != cell) {
+    cell = value;
+    markChanged(y, 1u << (x / DIRTY_CHUNK));
+  }
+}
+
+// Горизонтальный отрезок уже отсечённых координат: середина - по байтам.
+// Отмечаются только байты, которые на самом деле поменялись, так что
+// перерисовка тем же цветом на панель не уходит
+void ShadowFramebuffer::fillIndexSpan(int16_t x, int16_t y, int16_t w, uint8_t index) {
+  if (x & 1) {
+    setIndex(x, y, index);
+    ++x;
+    --w;
+  }
+  if (w <= 0) {
+    return;
+  }
+  const uint8_t pair = static_cast<uint8_t>(index | (index << 4));
+  uint8_t* row = &frame[y * ROW_BYTES];
+  uint32_t changed = 0;
+  for (int16_t i = x / 2; i < (x + w) / 2; ++i) {
+    if (row[i] != pair) {
+      row[i] = pair;
+      changed |= 1u << (i * 2 / DIRTY_CHUNK);
+    }
+  }
+  if (changed != 0) {
+    markChanged(y, changed);
+  }
+  if (w & 1) {
+    setIndex(x + w - 1, y, index);
+  }
+}
+
+void ShadowFramebuffer::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  writePixel(x, y, color);
+}
+
+void ShadowFramebuffer::writePixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || y < 0 || x >= _width || y >= _height) {
+    return;
+  }
+  setIndex(x, y, colorIndex(color));
+}
+
+void ShadowFramebuffer::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  if (h < 0) {
+    y += h + 1;
+    h = -h;
+  }
+  if (x < 0) {
+    w += x;
+    x = 0;
+  }
+  if (y < 0) {
+    h += y;
+    y = 0;
+  }
+  if (x + w > _width) {
+    w = _width - x;
+  }
+  if (y + h > _height) {
+    h = _height - y;
+  }
+  if (w <= 0 || h <= 0) {
+    return;
+  }
+
+  const uint8_t index = colorIndex(color);
+  for (int16_t row = y; row < y + h; ++row) {
+    fillIndexSpan(x, row, w, index);
+  }
+}
+
+void ShadowFramebuffer::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  writeFillRect(x, y, 1, h, color);
+}
+
+void ShadowFramebuffer::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  writeFillRect(x, y, w, 1, color);
+}
+
+void ShadowFramebuffer::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  DRAW_PROFILE_PRIMITIVE(FillRect);
+  writeFillRect(x, y, w, h, color);
+}
+
+void ShadowFramebuffer::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  writeFillRect(x, y, 1, h, color);
+}
+
+void ShadowFramebuffer::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  writeFillRect(x, y, w, 1, color);
+}
+
+// ----------------------------------------------------------
+// Потоковая запись окна (спрайты, картинки)
+// ----------------------------------------------------------
+
+void ShadowFramebuffer::setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+  windowX   = x;
+  windowY   = y;
+  windowW   = w;
+  windowH   = h;
+  windowPos = 0;
+}
+
+// Окно пишется отрезками строк: подряд идущие пиксели одного цвета
+// (серии спрайтов и картинок) ложатся в кадр целыми байтами
+void ShadowFramebuffer::pushPixels(const uint16_t* pixels, uint32_t count) {
+  const uint32_t total = static_cast<uint32_t>(windowW) * windowH;
+  while (count > 0 && windowPos < total) {
+    const uint16_t column = windowPos % windowW;
+    const uint16_t span   = static_cast<uint16_t>(min<uint32_t>(count, windowW - column));
+    const int16_t  x      = windowX + column;
+    const int16_t  y      = windowY + windowPos / windowW;
+    if (y < _height) {
+      for (uint16_t i = 0; i < span && x + i < _width;) {
+        uint16_t end = i + 1;
+        while (end < span && pixels[end] == pixels[i]) {
+          ++end;
+        }
+        fillIndexSpan(x + i, y, min<int16_t>(end - i, _width - (x + i)), colorIndex(pixels[i]));
+        i = end;
+      }
+    }
+    pixels    += span;
+    count     -= span;
+    windowPos += span;
+  }
+}
+
+void ShadowFramebuffer::pushColor(uint16_t color, uint32_t count) {
+  const uint8_t index = colorIndex(color);
+  const uint32_t total = static_cast<uint32_t>(windowW) * windowH;
+  while (count > 0 && windowPos < total) {
+    const uint16_t column = windowPos % windowW;
+    const uint16_t span   = static_cast<uint16_t>(min<uint32_t>(count, windowW - column));
+    const int16_t  x      = windowX + column;
+    const int16_t  y      = windowY + windowPos / windowW;
+    if (y < _height && x < _width) {
+      fillIndexSpan(x, y, min<int16_t>(span, _width - x), index);
+    }
+    count     -= span;
+    windowPos += span;
+  }
+}
+
+// ----------------------------------------------------------
+// Отправка отмеченных кусков
+// ----------------------------------------------------------
+
+void ShadowFramebuffer::invalidate() {
+  for (uint16_t y = 0; y < HEIGHT; ++y) {
+    dirtyChunks[y] = (1u << (WIDTH / DIRTY_CHUNK)) - 1;
+  }
+  dirtyMin = 0;
+  dirtyMax = HEIGHT - 1;
+}
+
+void ShadowFramebuffer::accept() {
+  for (int16_t y = dirtyMin; y <= dirtyMax; ++y) {
+    dirtyChunks[y] = 0;
+  }
+  dirtyMin = HEIGHT;
+  dirtyMax = -1;
+}
+
+void ShadowFramebuffer::sendWindow(RenderTarget& panel, uint16_t x0, uint16_t x1, uint16_t y0, uint16_t y1) {
+  uint16_t line[WIDTH];
+  const uint16_t w = x1 - x0 + 1;
+
+  panel.setAddrWindow(x0, y0, w, y1 - y0 + 1);
+  for (uint16_t y = y0; y <= y1; ++y) {
+    const uint8_t* row = &frame[y * ROW_BYTES];
+    for (uint16_t x = x0; x <= x1; ++x) {
+      const uint8_t cell = row[x / 2];
+      line[x - x0] = ShadowPalette::TABLE.colors[(x & 1) ? (cell >> 4) : (cell & 0x0F)];
+    }
+    panel.pushPixels(line, w);
+  }
+
+  lastFlushPixels += static_cast<uint32_t>(w) * (y1 - y0 + 1);
+  ++lastFlushWindows;
+}
+
+// Строки y0..y1 с одной маской: по окну на каждую серию отмеченных кусков
+void ShadowFramebuffer::sendRun(RenderTarget& panel, uint32_t chunks, uint16_t y0, uint16_t y1) {
+  uint16_t chunk = 0;
+  while (chunks != 0) {
+    while ((chunks & 1) == 0) {
+      chunks >>= 1;
+      ++chunk;
+    }
+    const uint16_t first = chunk;
+    while ((chunks & 1) != 0) {
+      chunks >>= 1;
+      ++chunk;
+    }
+    sendWindow(panel, first * DIRTY_CHUNK, chunk * DIRTY_CHUNK - 1, y0, y1);
+  }
+}
+
+uint32_t ShadowFramebuffer::flush(RenderTarget& panel) {
+  lastFlushPixels  = 0;
+  lastFlushWindows = 0;
+
+  // Текущая серия строк с одинаковой маской
+  int16_t  runY0     = -1;
+  uint32_t runChunks = 0;
+
+  for (int16_t y = dirtyMin; y <= dirtyMax; ++y) {
+    const uint32_t chunks = dirtyChunks[y];
+    dirtyChunks[y] = 0;
+
+    if (runY0 >= 0 && chunks != runChunks) {
+      sendRun(panel, runChunks, runY0, y - 1);
+      runY0 = -1;
+    }
+    if (runY0 < 0 && chunks != 0) {
+      runY0     = y;
+      runChunks = chunks;
+    }
+  }
+
+  if (runY0 >= 0) {
+    sendRun(panel, runChunks, runY0, dirtyMax);
+  }
+
+  dirtyMin = HEIGHT;
+  dirtyMax = -1;
+  return lastFlushPixels;
+}
@@ -0,0 +1,297 @@
+#include <Arduino.h>
+
+#include "st7735_display.h"
+
+// ----------------------------------------------------------
+// Таблицы инициализации (байт в байт как в Adafruit_ST7735)
+// Формат: число команд, затем для каждой:
+//   команда, число аргументов (| CMD_DELAY), аргументы, [задержка]
+// ----------------------------------------------------------
+
+namespace {
+
+constexpr uint8_t CMD_DELAY = 0x80;
+
+constexpr uint16_t NATIVE_WIDTH  = 128;
+constexpr uint16_t NATIVE_HEIGHT = 160;
+
+// Команды прокрутки (в Adafruit_ST77xx.h их нет)
+constexpr uint8_t ST7735_VSCRDEF  = 0x33;
+constexpr uint8_t ST7735_VSCRSADD = 0x37;
+
+const uint8_t RCMD1[] = {
+  15,
+  ST77XX_SWRESET, CMD_DELAY, 150,
+  ST77XX_SLPOUT,  CMD_DELAY, 255,
+  ST7735_FRMCTR1, 3, 0x01, 0x2C, 0x2D,
+  ST7735_FRMCTR2, 3, 0x01, 0x2C, 0x2D,
+  ST7735_FRMCTR3, 6, 0x01, 0x2C, 0x2D, 0x01, 0x2C, 0x2D,
+  ST7735_INVCTR,  1, 0x07,
+  ST7735_PWCTR1,  3, 0xA2, 0x02, 0x84,
+  ST7735_PWCTR2,  1, 0xC5,
+  ST7735_PWCTR3,  2, 0x0A, 0x00,
+  ST7735_PWCTR4,  2, 0x8A, 0x2A,
+  ST7735_PWCTR5,  2, 0x8A, 0xEE,
+  ST7735_VMCTR1,  1, 0x0E,
+  ST77XX_INVOFF,  0,
+  ST77XX_MADCTL,  1, 0xC8,
+  ST77XX_COLMOD,  1, 0x05
+};
+
+const uint8_t RCMD2_GREEN[] = {
+  2,
+  ST77XX_CASET, 4, 0x00, 0x02, 0x00, 0x7F + 0x02,
+  ST77XX_RASET, 4, 0x00, 0x01, 0x00, 0x9F + 0x01
+};
+
+const uint8_t RCMD2_RED[] = {
+  2,
+  ST77XX_CASET, 4, 0x00, 0x00, 0x00, 0x7F,
+  ST77XX_RASET, 4, 0x00, 0x00, 0x00, 0x9F
+};
+
+const uint8_t RCMD3[] = {
+  4,
+  ST7735_GMCTRP1, 16,
+    0x02, 0x1c, 0x07, 0x12, 0x37, 0x32, 0x29, 0x2d,
+    0x29, 0x25, 0x2B, 0x39, 0x00, 0x01, 0x03, 0x10,
+  ST7735_GMCTRN1, 16,
+    0x03, 0x1d, 0x07, 0x06, 0x2E, 0x2C, 0x29, 0x2D,
+    0x2E, 0x2E, 0x37, 0x3F, 0x00, 0x00, 0x02, 0x10,
+  ST77XX_NORON,  CMD_DELAY, 10,
+  ST77XX_DISPON, CMD_DELAY, 100
+};
+
+} // namespace
+
+St7735Display::St7735Display(TftBus& bus)
+  : RenderTarget(NATIVE_WIDTH, NATIVE_HEIGHT), tftBus(bus) {}
+
+void St7735Display::runCommandList(const uint8_t* list) {
+  uint8_t commands = *list++;
+  while (commands--) {
+    const uint8_t cmd  = *list++;
+    const uint8_t args = *list++;
+    const uint8_t count = args & ~CMD_DELAY;
+    sendCommand(cmd, list, count);
+    list += count;
+
+    if (args & CMD_DELAY) {
+      uint16_t ms = *list++;
+      if (ms == 255) {
+        ms = 500;
+      }
+      tftBus.flush();
+      delay(ms);
+    }
+  }
+}
+
+void St7735Display::initR(uint8_t options) {
+  tftBus.begin();
+
+  runCommandList(RCMD1);
+  if (options == INITR_GREENTAB) {
+    runCommandList(RCMD2_GREEN);
+    colStart = 2;
+    rowStart = 1;
+  } else {
+    // Остальные варианты (в т.ч. BLACKTAB) - без смещения
+    runCommandList(RCMD2_RED);
+    colStart = 0;
+    rowStart = 0;
+  }
+  runCommandList(RCMD3);
+
+  // У BLACKTAB другой порядок цветов в MADCTL
+  if (options == INITR_BLACKTAB) {
+    const uint8_t madctl = 0xC0;
+    sendCommand(ST77XX_MADCTL, &madctl, 1);
+  }
+
+  tabColor = options;
+  setRotation(0);
+}
+
+void St7735Display::setRotation(uint8_t r) {
+  rotation = r & 3;
+  const uint8_t colorOrder =
+      (tabColor == INITR_BLACKTAB) ? ST77XX_MADCTL_RGB : ST7735_MADCTL_BGR;
+
+  uint8_t madctl = 0;
+  switch (rotation) {
+    case 0:
+      madctl = ST77XX_MADCTL_MX | ST77XX_MADCTL_MY | colorOrder;
+      break;
+    case 1:
+      madctl = ST77XX_MADCTL_MY | ST77XX_MADCTL_MV | colorOrder;
+      break;
+    case 2:
+      madctl = colorOrder;
+      break;
+    case 3:
+      madctl = ST77XX_MADCTL_MX | ST77XX_MADCTL_MV | colorOrder;
+      break;
+  }
+
+  if (rotation & 1) {
+    _width  = NATIVE_HEIGHT;
+    _height = NATIVE_WIDTH;
+    xStart  = rowStart;
+    yStart  = colStart;
+  } else {
+    _width  = NATIVE_WIDTH;
+    _height = NATIVE_HEIGHT;
+    xStart  = colStart;
+    yStart  = rowStart;
+  }
+
+  sendCommand(ST77XX_MADCTL, &madctl, 1);
+}
+
+void St7735Display::invertDisplay(bool invert) {
+  DRAW_PROFILE_PRIMITIVE(Command);
+  sendCommand(invert ? ST77XX_INVON : ST77XX_INVOFF);
+}
+
+void St7735Display::enableDisplay(bool enable) {
+  DRAW_PROFILE_PRIMITIVE(Command);
+  sendCommand(enable ? ST77XX_DISPON : ST77XX_DISPOFF);
+}
+
+void St7735Display::setScrollArea(uint16_t top, uint16_t lines, uint16_t bottom) {
+  DRAW_PROFILE_PRIMITIVE(Command);
+  const uint8_t area[6] = {
+    static_cast<uint8_t>(top >> 8),    static_cast<uint8_t>(top),
+    static_cast<uint8_t>(lines >> 8),  static_cast<uint8_t>(lines),
+    static_cast<uint8_t>(bottom >> 8), static_cast<uint8_t>(bottom)
+  };
+  sendCommand(ST7735_VSCRDEF, area, sizeof(area));
+}
+
+void St7735Display::scrollTo(uint16_t line) {
+  DRAW_PROFILE_PRIMITIVE(Command);
+  const uint8_t start[2] = {static_cast<uint8_t>(line >> 8), static_cast<uint8_t>(line)};
+  sendCommand(ST7735_VSCRSADD, start, sizeof(start));
+}
+
+void St7735Display::endScroll() {
+  DRAW_PROFILE_PRIMITIVE(Command);
+  sendCommand(ST77XX_NORON);
+}
+
+void St7735Display::sendCommand(uint8_t cmd, const uint8_t* data, uint8_t len) {
+  tftBus.writeCommand(cmd);
+  if (len > 0) {
+    tftBus.writeData(data, len);
+  }
+}
+
+void St7735Display::setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+  x += xStart;
+  y += yStart;
+  const uint16_t x2 = x + w - 1;
+  const uint16_t y2 = y + h - 1;
+
+  const uint8_t columns[4] = {
+    static_cast<uint8_t>(x >> 8),  static_cast<uint8_t>(x),
+    static_cast<uint8_t>(x2 >> 8), static_cast<uint8_t>(x2)
+  };
+  const uint8_t rows[4] = {
+    static_cast<uint8_t>(y >> 8),  static_cast<uint8_t>(y),
+    static_cast<uint8_t>(y2 >> 8), static_cast<uint8_t>(y2)
+  };
+
+  sendCommand(ST77XX_CASET, columns, 4);
+  sendCommand(ST77XX_RASET, rows, 4);
+  tftBus.writeCommand(ST77XX_RAMWR);
+}
+
+void St7735Display::pushPixels(const uint16_t* pixels, uint32_t count) {
+  tftBus.writePixels(pixels, count);
+}
+
+void St7735Display::pushColor(uint16_t color, uint32_t count) {
+  tftBus.writeColor(color, count);
+}
+
+void St7735Display::flush() {
+  tftBus.flush();
+}
+
+// ----------------------------------------------------------
+// Примитивы (отсечение как в Adafruit_SPITFT)
+// ----------------------------------------------------------
+
+void St7735Display::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  writePixel(x, y, color);
+}
+
+void St7735Display::writePixel(int16_t x, int16_t y, uint16_t color) {
+  if (x >= 0 && x < _width && y >= 0 && y < _height) {
+    setAddrWindow(x, y, 1, 1);
+    tftBus.writeColor(color, 1);
+  }
+}
+
+void St7735Display::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (w == 0 || h == 0) {
+    return;
+  }
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  if (h < 0) {
+    y += h + 1;
+    h = -h;
+  }
+  if (x >= _width || y >= _height) {
+    return;
+  }
+
+  const int16_t x2 = x + w - 1;
+  const int16_t y2 = y + h - 1;
+  if (x2 < 0 || y2 < 0) {
+    return;
+  }
+
+  if (x < 0) {
+    x = 0;
+    w = x2 + 1;
+  }
+  if (y < 0) {
+    y = 0;
+    h = y2 + 1;
+  }
+  if (x2 >= _width) {
+    w = _width - x;
+  }
+  if (y2 >= _height) {
+    h = _height - y;
+  }
+
+  setAddrWindow(x, y, w, h);
+  tftBus.writeColor(color, static_cast<uint32_t>(w) * h);
+}
+
+void St7735Display::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  writeFillRect(x, y, 1, h, color);
+}
+
+void St7735Display::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  writeFillRect(x, y, w, 1, color);
+}
+
+void St7735Display::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  DRAW_PROFILE_PRIMITIVE(FillRect);
+  writeFillRect(x, y, w, h, color);
+}
+
+void St7735Display::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  writeFillRect(x, y, 1, h, color);
+}
+
+void St7735Display::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  writeFillRect(x, y, w, 1, color);
+}
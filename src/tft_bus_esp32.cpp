@@ -0,0 +1,250 @@
+#if defined(ESP32)
+
+#include <Arduino.h>
+#include <Adafruit_ST7735.h>
+#include <driver/gpio.h>
+#include <esp_heap_caps.h>
+#include <string.h>
+
+#include "config.h"
+#include "tft_bus.h"
+
+// ----------------------------------------------------------
+// Аппаратный VSPI с очередью DMA-транзакций
+// ----------------------------------------------------------
+
+namespace {
+
+// VSPI в терминах ESP-IDF
+constexpr spi_host_device_t TFT_SPI_HOST = SPI3_HOST;
+
+// Пин DC переключается драйвером spi_master перед каждой транзакцией.
+// Уровень DC хранится в поле user транзакции.
+gpio_num_t dcGpio = GPIO_NUM_NC;
+
+void IRAM_ATTR setDcBeforeTransfer(spi_transaction_t* t) {
+  gpio_set_level(dcGpio, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(t->user)));
+}
+
+inline uint16_t swapBytes(uint16_t value) {
+  return static_cast<uint16_t>((value >> 8) | (value << 8));
+}
+
+void* dcLevel(uint8_t level) {
+  return reinterpret_cast<void*>(static_cast<uintptr_t>(level));
+}
+
+} // namespace
+
+Esp32DmaBus::Esp32DmaBus(uint8_t cs, uint8_t dc, uint8_t mosi, uint8_t sclk, uint8_t rst, uint32_t freqHz)
+  : csPin(cs), dcPin(dc), mosiPin(mosi), sclkPin(sclk), rstPin(rst), frequency(freqHz) {}
+
+void Esp32DmaBus::begin() {
+  pinMode(dcPin, OUTPUT);
+  digitalWrite(dcPin, HIGH);
+  dcGpio = static_cast<gpio_num_t>(dcPin);
+
+  // Аппаратный сброс с теми же паузами, что и в Adafruit_ST7735
+  pinMode(rstPin, OUTPUT);
+  digitalWrite(rstPin, HIGH);
+  delay(100);
+  digitalWrite(rstPin, LOW);
+  delay(100);
+  digitalWrite(rstPin, HIGH);
+  delay(200);
+
+  if (device != nullptr) {
+    // Повторная инициализация (например, повторный initR) - шина уже настроена
+    flush();
+    return;
+  }
+
+  const size_t chunkBytes = Config::Hardware::TFT_DMA_CHUNK_PIXELS * sizeof(uint16_t);
+
+  spi_bus_config_t busConfig = {};
+  busConfig.mosi_io_num     = mosiPin;
+  busConfig.miso_io_num     = -1;
+  busConfig.sclk_io_num     = sclkPin;
+  busConfig.quadwp_io_num   = -1;
+  busConfig.quadhd_io_num   = -1;
+  busConfig.max_transfer_sz = chunkBytes;
+  ESP_ERROR_CHECK(spi_bus_initialize(TFT_SPI_HOST, &busConfig, SPI_DMA_CH_AUTO));
+
+  spi_device_interface_config_t deviceConfig = {};
+  deviceConfig.clock_speed_hz = static_cast<int>(frequency);
+  deviceConfig.mode           = 0;
+  deviceConfig.spics_io_num   = csPin;
+  deviceConfig.queue_size     = Config::Hardware::TFT_DMA_QUEUE_DEPTH;
+  deviceConfig.pre_cb         = setDcBeforeTransfer;
+  ESP_ERROR_CHECK(spi_bus_add_device(TFT_SPI_HOST, &deviceConfig, &device));
+
+  transactions = static_cast<spi_transaction_t*>(
+      calloc(Config::Hardware::TFT_DMA_QUEUE_DEPTH, sizeof(spi_transaction_t)));
+  bool allocated = transactions != nullptr;
+  for (uint8_t i = 0; i < BUFFER_COUNT; ++i) {
+    buffers[i] = static_cast<uint16_t*>(heap_caps_malloc(chunkBytes, MALLOC_CAP_DMA));
+    allocated &= buffers[i] != nullptr;
+  }
+  // Без памяти под очередь или DMA первая же транзакция разыменует nullptr -
+  // останавливаемся сразу и с понятной причиной
+  if (!allocated) {
+    Serial.print("TFT bus: no DMA memory for ");
+    Serial.print(BUFFER_COUNT);
+    Serial.print(" x ");
+    Serial.print(chunkBytes);
+    Serial.println(" bytes (Config::Hardware::TFT_DMA_CHUNK_PIXELS)");
+    ESP_ERROR_CHECK(ESP_ERR_NO_MEM);
+  }
+
+  Serial.print("TFT bus: VSPI DMA @ ");
+  Serial.print(frequency / 1000000UL);
+  Serial.println(" MHz");
+}
+
+// Свободная структура транзакции; если очередь заполнена - ждём самую старую
+spi_transaction_t* Esp32DmaBus::nextTransaction() {
+  if (inFlight == Config::Hardware::TFT_DMA_QUEUE_DEPTH) {
+    waitOne();
+  }
+  spi_transaction_t* t = &transactions[transactionHead];
+  transactionHead = static_cast<uint8_t>((transactionHead + 1) % Config::Hardware::TFT_DMA_QUEUE_DEPTH);
+  memset(t, 0, sizeof(*t));
+  return t;
+}
+
+void Esp32DmaBus::queue(spi_transaction_t* t) {
+  ESP_ERROR_CHECK(spi_device_queue_trans(device, t, portMAX_DELAY));
+  ++inFlight;
+  ++submitted;
+}
+
+void Esp32DmaBus::waitOne() {
+  spi_transaction_t* done = nullptr;
+  ESP_ERROR_CHECK(spi_device_get_trans_result(device, &done, portMAX_DELAY));
+  --inFlight;
+  ++completed;
+}
+
+// Следующий DMA-буфер; перед переиспользованием ждём, пока DMA его дочитает
+uint16_t* Esp32DmaBus::acquireBuffer(uint8_t& index) {
+  index = nextBuffer;
+  nextBuffer = static_cast<uint8_t>((nextBuffer + 1) % BUFFER_COUNT);
+  while (completed < bufferFence[index]) {
+    waitOne();
+  }
+  return buffers[index];
+}
+
+void Esp32DmaBus::writeCommand(uint8_t cmd) {
+  spi_transaction_t* t = nextTransaction();
+  t->flags      = SPI_TRANS_USE_TXDATA;
+  t->length     = 8;
+  t->tx_data[0] = cmd;
+  t->user       = dcLevel(0);
+  queue(t);
+}
+
+void Esp32DmaBus::writeData(const uint8_t* data, size_t len) {
+  while (len > 0) {
+    spi_transaction_t* t = nextTransaction();
+    t->user = dcLevel(1);
+
+    if (len <= sizeof(t->tx_data)) {
+      // Короткие параметры (CASET/RASET, MADCTL...) копируются прямо в транзакцию
+      t->flags  = SPI_TRANS_USE_TXDATA;
+      t->length = len * 8;
+      memcpy(t->tx_data, data, len);
+      queue(t);
+      return;
+    }
+
+    uint8_t index;
+    uint8_t* buffer = reinterpret_cast<uint8_t*>(acquireBuffer(index));
+    const size_t part = min(len, Config::Hardware::TFT_DMA_CHUNK_PIXELS * sizeof(uint16_t));
+    memcpy(buffer, data, part);
+    t->length    = part * 8;
+    t->tx_buffer = buffer;
+    queue(t);
+    bufferFence[index] = submitted;
+
+    data += part;
+    len  -= part;
+  }
+}
+
+void Esp32DmaBus::writeColor(uint16_t color, uint32_t count) {
+  if (count == 0) {
+    return;
+  }
+
+  // Один буфер заполняется цветом и отправляется столько раз, сколько нужно
+  uint8_t index;
+  uint16_t* buffer = acquireBuffer(index);
+  const uint32_t fill = min<uint32_t>(count, Config::Hardware::TFT_DMA_CHUNK_PIXELS);
+  const uint16_t swapped = swapBytes(color);
+  for (uint32_t i = 0; i < fill; ++i) {
+    buffer[i] = swapped;
+  }
+
+  while (count > 0) {
+    const uint32_t part = min(count, fill);
+    spi_transaction_t* t = nextTransaction();
+    t->length    = part * 16;
+    t->tx_buffer = buffer;
+    t->user      = dcLevel(1);
+    queue(t);
+    count -= part;
+  }
+  bufferFence[index] = submitted;
+}
+
+void Esp32DmaBus::writePixels(const uint16_t* pixels, uint32_t count) {
+  // Буферы чередуются: пока DMA отправляет один, CPU копирует в другой
+  while (count > 0) {
+    uint8_t index;
+    uint16_t* buffer = acquireBuffer(index);
+    const uint32_t part = min<uint32_t>(count, Config::Hardware::TFT_DMA_CHUNK_PIXELS);
+    for (uint32_t i = 0; i < part; ++i) {
+      buffer[i] = swapBytes(pixels[i]);
+    }
+
+    spi_transaction_t* t = nextTransaction();
+    t->length    = part * 16;
+    t->tx_buffer = buffer;
+    t->user      = dcLevel(1);
+    queue(t);
+    bufferFence[index] = submitted;
+
+    pixels += part;
+    count  -= part;
+  }
+}
+
+// Буфер вызывающего уходит в DMA как есть; метка - номер последней транзакции
+uint32_t Esp32DmaBus::queuePixels(const uint16_t* wirePixels, uint32_t count) {
+  while (count > 0) {
+    const uint32_t part = min<uint32_t>(count, Config::Hardware::TFT_DMA_CHUNK_PIXELS);
+    spi_transaction_t* t = nextTransaction();
+    t->length    = part * 16;
+    t->tx_buffer = wirePixels;
+    t->user      = dcLevel(1);
+    queue(t);
+    wirePixels += part;
+    count      -= part;
+  }
+  return submitted;
+}
+
+void Esp32DmaBus::waitQueued(uint32_t token) {
+  while (completed < token) {
+    waitOne();
+  }
+}
+
+void Esp32DmaBus::flush() {
+  while (inFlight > 0) {
+    waitOne();
+  }
+}
+
+#endif // defined(ESP32)
@@ -0,0 +1,67 @@
+#include <Arduino.h>
+
+#include "tft_bus.h"
+
+// ----------------------------------------------------------
+// Программный SPI (режим 0, старший бит первым)
+// ----------------------------------------------------------
+
+SoftSpiBus::SoftSpiBus(uint8_t cs, uint8_t dc, uint8_t mosi, uint8_t sclk, uint8_t rst)
+  : csPin(cs), dcPin(dc), mosiPin(mosi), sclkPin(sclk), rstPin(rst) {}
+
+void SoftSpiBus::begin() {
+  pinMode(csPin, OUTPUT);
+  pinMode(dcPin, OUTPUT);
+  pinMode(mosiPin, OUTPUT);
+  pinMode(sclkPin, OUTPUT);
+  digitalWrite(sclkPin, LOW);
+  digitalWrite(mosiPin, LOW);
+
+  // Дисплей на шине один, поэтому CS держим активным постоянно
+  digitalWrite(csPin, LOW);
+
+  // Аппаратный сброс с теми же паузами, что и в Adafruit_ST7735
+  pinMode(rstPin, OUTPUT);
+  digitalWrite(rstPin, HIGH);
+  delay(100);
+  digitalWrite(rstPin, LOW);
+  delay(100);
+  digitalWrite(rstPin, HIGH);
+  delay(200);
+}
+
+void SoftSpiBus::writeByte(uint8_t value) {
+  for (uint8_t bit = 0x80; bit; bit >>= 1) {
+    digitalWrite(mosiPin, (value & bit) ? HIGH : LOW);
+    digitalWrite(sclkPin, HIGH);
+    digitalWrite(sclkPin, LOW);
+  }
+}
+
+void SoftSpiBus::writeCommand(uint8_t cmd) {
+  digitalWrite(dcPin, LOW);
+  writeByte(cmd);
+  digitalWrite(dcPin, HIGH);
+}
+
+void SoftSpiBus::writeData(const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    writeByte(data[i]);
+  }
+}
+
+void SoftSpiBus::writeColor(uint16_t color, uint32_t count) {
+  const uint8_t hi = color >> 8;
+  const uint8_t lo = color & 0xFF;
+  while (count--) {
+    writeByte(hi);
+    writeByte(lo);
+  }
+}
+
+void SoftSpiBus::writePixels(const uint16_t* pixels, uint32_t count) {
+  for (uint32_t i = 0; i < count; ++i) {
+    writeByte(pixels[i] >> 8);
+    writeByte(pixels[i] & 0xFF);
+  }
+}
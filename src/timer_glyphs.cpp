@@ -0,0 +1,45 @@
+#include <Arduino.h>
+
+#include "timer_glyphs.h"
+
+// ----------------------------------------------------------
+// Распаковка RLE-глифа прямо в окно дисплея
+// ----------------------------------------------------------
+
+namespace TimerGlyphs {
+
+namespace {
+
+// Одна строка шрифта (SCALE строк пикселей) за одну передачу
+constexpr uint32_t BLOCK_PIXELS = static_cast<uint32_t>(CELL_W) * SCALE;
+uint16_t blockBuffer[BLOCK_PIXELS];
+
+} // namespace
+
+void drawDigit(RenderTarget& target, int16_t x, int16_t y, uint8_t digit, uint16_t color, uint16_t background) {
+  if (digit > 9) {
+    return;
+  }
+  DRAW_PROFILE_PRIMITIVE(Glyph);
+
+  target.setAddrWindow(x, y, CELL_W, CELL_H);
+
+  uint32_t filled = 0;
+  bool foreground = false;
+  for (uint16_t i = ATLAS.offset[digit]; i < ATLAS.offset[digit + 1]; ++i) {
+    const uint16_t pixel = foreground ? color : background;
+    for (uint8_t run = ATLAS.runs[i]; run > 0; --run) {
+      blockBuffer[filled++] = pixel;
+      if (filled == BLOCK_PIXELS) {
+        target.pushPixels(blockBuffer, filled);
+        filled = 0;
+      }
+    }
+    foreground = !foreground;
+  }
+  if (filled > 0) {
+    target.pushPixels(blockBuffer, filled);
+  }
+}
+
+} // namespace TimerGlyphs
@@ -0,0 +1,216 @@
+#include <Arduino.h>
+
+#include <stddef.h>
+
+#include <utility>
+
+#include "tumble_atlas.h"
+
+// ----------------------------------------------------------
+// Генерация атласа при компиляции
+// ----------------------------------------------------------
+
+namespace TumbleAtlas {
+
+namespace {
+
+// Палитра спрайта; реальные цвета подставляются при выводе
+enum Ink : uint8_t { INK_BACKGROUND, INK_FILL, INK_PIP, INK_BORDER };
+
+constexpr uint8_t RUN_BITS = 6;
+constexpr uint8_t MAX_RUN  = 1u << RUN_BITS;
+
+// cos и sin углов k * 15 градусов в формате Q12
+constexpr int32_t Q = 4096;
+constexpr int32_t COS_Q[ANGLE_COUNT] = {4096, 3956, 3547, 2896, 2048, 1060};
+constexpr int32_t SIN_Q[ANGLE_COUNT] = {0, 1060, 2048, 2896, 3547, 3956};
+
+// ----------------------------------------------------------
+// Растеризация (все координаты удвоены: центр пикселя - целое число)
+// ----------------------------------------------------------
+
+constexpr int32_t abs32(int32_t v) {
+  return v < 0 ? -v : v;
+}
+
+// Внутри ли скруглённого квадрата с полустороной half и радиусом radius
+constexpr bool insideRoundRect(int32_t ax, int32_t ay, int32_t half, int32_t radius) {
+  if (ax > half || ay > half) {
+    return false;
+  }
+  const int32_t cx = ax - (half - radius);
+  const int32_t cy = ay - (half - radius);
+  return cx <= 0 || cy <= 0 || cx * cx + cy * cy <= radius * radius;
+}
+
+constexpr Ink inkAt(uint8_t angle, uint8_t value, uint16_t px, uint16_t py) {
+  const int32_t c = COS_Q[angle];
+  const int32_t s = SIN_Q[angle];
+  // Повёрнутый кубик вписан в квадрат: сторона SIZE / (cos + sin)
+  const int32_t scale = c + s;
+
+  const int32_t dx = 2 * px + 1 - SIZE;
+  const int32_t dy = 2 * py + 1 - SIZE;
+  // Обратный поворот и растяжение к исходной грани
+  const int32_t lx = static_cast<int32_t>((static_cast<int64_t>(c * dx + s * dy) * scale) / (Q * Q));
+  const int32_t ly = static_cast<int32_t>((static_cast<int64_t>(c * dy - s * dx) * scale) / (Q * Q));
+
+  const int32_t half   = SIZE;
+  const int32_t radius = 2 * Config::Dice::RADIUS;
+  if (!insideRoundRect(abs32(lx), abs32(ly), half, radius)) {
+    return INK_BACKGROUND;
+  }
+  // Рамка шириной в пиксель экрана (в координатах грани - scale / Q)
+  const int32_t border = (2 * scale + Q - 1) / Q;
+  if (!insideRoundRect(abs32(lx), abs32(ly), half - border, radius - border)) {
+    return INK_BORDER;
+  }
+
+  const uint16_t mask = PipSprites::faceMask(value);
+  const int32_t  dot  = 2 * Config::Dice::DOT_RADIUS + 1;
+  for (uint8_t p = 0; p < PipSprites::POSITION_COUNT; ++p) {
+    if (mask & (1u << p)) {
+      const int32_t ox = lx - (2 * PipSprites::POSITION_X[p] + 1 - SIZE);
+      const int32_t oy = ly - (2 * PipSprites::POSITION_Y[p] + 1 - SIZE);
+      if (ox * ox + oy * oy <= dot * dot) {
+        return INK_PIP;
+      }
+    }
+  }
+  return INK_FILL;
+}
+
+// RLE: out == nullptr - только подсчёт длины
+constexpr uint32_t encode(uint8_t angle, uint8_t value, uint8_t* out) {
+  uint32_t length = 0;
+  for (uint16_t y = 0; y < SIZE; ++y) {
+    Ink     ink = inkAt(angle, value, 0, y);
+    uint8_t run = 1;
+    for (uint16_t x = 1; x <= SIZE; ++x) {
+      const Ink next = x < SIZE ? inkAt(angle, value, x, y) : ink;
+      if (x < SIZE && next == ink && run < MAX_RUN) {
+        ++run;
+        continue;
+      }
+      if (out) {
+        out[length] = static_cast<uint8_t>((ink << RUN_BITS) | (run - 1));
+      }
+      ++length;
+      ink = next;
+      run = 1;
+    }
+  }
+  return length;
+}
+
+template <uint8_t ANGLE, uint8_t VALUE>
+struct Sprite {
+  static constexpr uint32_t LENGTH = encode(ANGLE, VALUE, nullptr);
+  uint8_t runs[LENGTH];
+};
+
+template <uint8_t ANGLE, uint8_t VALUE>
+constexpr Sprite<ANGLE, VALUE> buildSprite() {
+  Sprite<ANGLE, VALUE> sprite{};
+  encode(ANGLE, VALUE, sprite.runs);
+  return sprite;
+}
+
+// Каждый спрайт - отдельная константа: вычисления при компиляции
+// не упираются в лимит одного константного выражения
+template <uint8_t ANGLE, uint8_t VALUE>
+constexpr Sprite<ANGLE, VALUE> SPRITE = buildSprite<ANGLE, VALUE>();
+
+struct Entry {
+  const uint8_t* runs;
+  uint32_t       length;
+};
+
+template <size_t... I>
+constexpr auto buildTable(std::index_sequence<I...>) {
+  struct Table {
+    Entry entries[sizeof...(I)];
+  };
+  return Table{{Entry{SPRITE<I / FACE_COUNT, I % FACE_COUNT>.runs,
+                      Sprite<I / FACE_COUNT, I % FACE_COUNT>::LENGTH}...}};
+}
+
+// Спрайт угла a и грани v - TABLE.entries[a * FACE_COUNT + v]
+constexpr auto TABLE = buildTable(std::make_index_sequence<ANGLE_COUNT * FACE_COUNT>{});
+
+constexpr uint32_t totalBytes() {
+  uint32_t total = 0;
+  for (const Entry& entry : TABLE.entries) {
+    total += entry.length;
+  }
+  return total;
+}
+
+// ----------------------------------------------------------
+// Распаковка RLE построчно в окно дисплея
+// ----------------------------------------------------------
+
+// Одна строка спрайта
+uint16_t rowBuffer[SIZE];
+
+} // namespace
+
+uint32_t atlasBytes() {
+  return totalBytes();
+}
+
+void draw(RenderTarget& target, int16_t x, int16_t y, uint8_t angle, uint8_t value,
+          uint16_t fillColor, uint16_t background) {
+  if (value >= FACE_COUNT) {
+    return;
+  }
+  DRAW_PROFILE_PRIMITIVE(Sprite);
+
+  const Entry& sprite = TABLE.entries[(angle % ANGLE_COUNT) * FACE_COUNT + value];
+  const uint16_t palette[4] = {background, fillColor, Config::Colors::DICE_PIP, Config::Colors::DICE_BORDER};
+
+  target.setAddrWindow(x, y, SIZE, SIZE);
+  uint16_t filled = 0;
+  for (uint32_t i = 0; i < sprite.length; ++i) {
+    const uint8_t  code  = sprite.runs[i];
+    const uint16_t color = palette[code >> RUN_BITS];
+    for (uint8_t run = (code & (MAX_RUN - 1)) + 1; run > 0; --run) {
+      rowBuffer[filled++] = color;
+    }
+    // Серии не переходят через строку: строка собрана - сразу на шину
+    if (filled == SIZE) {
+      target.pushPixels(rowBuffer, SIZE);
+      filled = 0;
+    }
+  }
+}
+
+// Серии идут построчно: из каждой строки берётся пересечение с [column, end)
+void columns(uint8_t value, uint16_t column, uint16_t count, uint16_t fillColor, uint16_t background,
+             uint16_t* out, uint16_t stride) {
+  if (value >= FACE_COUNT) {
+    return;
+  }
+
+  const Entry& sprite = TABLE.entries[value];
+  const uint16_t palette[4] = {background, fillColor, Config::Colors::DICE_PIP, Config::Colors::DICE_BORDER};
+  const uint16_t end = column + count;
+
+  uint16_t x = 0;
+  uint16_t* row = out;
+  for (uint32_t i = 0; i < sprite.length; ++i) {
+    const uint8_t  code  = sprite.runs[i];
+    const uint16_t color = palette[code >> RUN_BITS];
+    const uint16_t next  = x + (code & (MAX_RUN - 1)) + 1;
+    for (uint16_t c = max(x, column); c < min(next, end); ++c) {
+      row[c - column] = color;
+    }
+    x = next;
+    if (x == SIZE) {
+      x    = 0;
+      row += stride;
+    }
+  }
+}
+
+} // namespace TumbleAtlas
@@ -0,0 +1,176 @@
+#include <unity.h>
+
+#include <Arduino.h>
+#include <Adafruit_ST7735.h>
+
+#include <vector>
+
+#include "button_input.h"
+#include "config.h"
+#include "host_pins.h"
+#include "virtual_clock.h"
+
+// ----------------------------------------------------------
+// Жесты ButtonInput по синтетическим фронтам на виртуальных часах.
+// Фронты подаются через HostPins (как прерывание на плате), время
+// сценария отсчитывается от начала теста, а каждый тест начинается
+// с отпущенной кнопки после паузы длиннее любого окна жестов.
+// ----------------------------------------------------------
+
+using ButtonInput::Gesture;
+
+namespace {
+
+constexpr uint8_t  PIN           = Config::Hardware::BUTTON_PIN;
+constexpr uint64_t QUIET_US      = 10ULL * 1000 * 1000;
+constexpr uint32_t EDGE_CAPACITY = Config::Input::EDGE_QUEUE_SIZE;
+
+uint64_t startUs = 0;
+
+uint64_t atUs(unsigned long ms) {
+  return startUs + static_cast<uint64_t>(ms) * 1000;
+}
+
+// Перевести часы на момент ms сценария
+void moveTo(unsigned long ms) {
+  if (atUs(ms) > VirtualClock::nowUs()) {
+    VirtualClock::setUs(atUs(ms));
+  }
+}
+
+void edge(unsigned long ms, uint8_t level) {
+  moveTo(ms);
+  HostPins::setInput(PIN, level);
+}
+
+// poll() в момент ms и все распознанные к нему жесты
+std::vector<ButtonInput::Event> pollAt(unsigned long ms) {
+  moveTo(ms);
+  ButtonInput::poll(VirtualClock::nowUs());
+  std::vector<ButtonInput::Event> events;
+  ButtonInput::Event event;
+  while (ButtonInput::nextEvent(event)) {
+    events.push_back(event);
+  }
+  return events;
+}
+
+void assertGestures(const std::vector<ButtonInput::Event>& events, std::vector<Gesture> expected) {
+  TEST_ASSERT_EQUAL_UINT32(expected.size(), events.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    TEST_ASSERT_EQUAL_STRING(ButtonInput::gestureName(expected[i]), ButtonInput::gestureName(events[i].gesture));
+  }
+}
+
+} // namespace
+
+void setUp() {
+  HostPins::setInput(PIN, HIGH);
+  VirtualClock::advanceUs(QUIET_US);
+  startUs = VirtualClock::nowUs();
+  pollAt(0);
+}
+
+void tearDown() {}
+
+void test_short_press() {
+  edge(0, LOW);
+  edge(100, HIGH);
+  const std::vector<ButtonInput::Event> events = pollAt(120);
+  assertGestures(events, {Gesture::ShortPress});
+  TEST_ASSERT_EQUAL_UINT64(atUs(100), events[0].edgeUs);
+}
+
+// Событие - по порогу, не дожидаясь отпускания; poll() может опоздать
+void test_long_press() {
+  edge(0, LOW);
+  assertGestures(pollAt(Config::Input::LONG_PRESS_MS - 1), {});
+  TEST_ASSERT_EQUAL_UINT64(atUs(Config::Input::LONG_PRESS_MS), ButtonInput::nextDeadlineUs());
+
+  const std::vector<ButtonInput::Event> events = pollAt(Config::Input::LONG_PRESS_MS + 250);
+  assertGestures(events, {Gesture::LongPress});
+  TEST_ASSERT_EQUAL_UINT64(atUs(Config::Input::LONG_PRESS_MS), events[0].edgeUs);
+
+  edge(Config::Input::LONG_PRESS_MS + 500, HIGH);
+  assertGestures(pollAt(Config::Input::LONG_PRESS_MS + 600), {});
+}
+
+void test_double_click() {
+  edge(0, LOW);
+  edge(100, HIGH);
+  edge(200, LOW);
+  edge(300, HIGH);
+  assertGestures(pollAt(400), {Gesture::ShortPress, Gesture::DoubleClick});
+}
+
+// Второе нажатие позже DOUBLE_CLICK_MS - два отдельных коротких
+void test_slow_clicks_stay_short() {
+  edge(0, LOW);
+  edge(100, HIGH);
+  assertGestures(pollAt(150), {Gesture::ShortPress});
+  edge(100 + Config::Input::DOUBLE_CLICK_MS + 1, LOW);
+  edge(200 + Config::Input::DOUBLE_CLICK_MS + 1, HIGH);
+  assertGestures(pollAt(300 + Config::Input::DOUBLE_CLICK_MS), {Gesture::ShortPress});
+}
+
+// Дребезг на обоих фронтах короче DEBOUNCE_MS - одно нажатие
+void test_bounce_is_one_press() {
+  for (unsigned long t = 0; t < 4; ++t) {
+    edge(t, (t % 2 == 0) ? LOW : HIGH);
+  }
+  edge(4, LOW);
+  for (unsigned long t = 0; t < 4; ++t) {
+    edge(100 + t, (t % 2 == 0) ? HIGH : LOW);
+  }
+  edge(104, HIGH);
+
+  const std::vector<ButtonInput::Event> events = pollAt(200);
+  assertGestures(events, {Gesture::ShortPress});
+  TEST_ASSERT_EQUAL_UINT64(atUs(100), events[0].edgeUs);
+}
+
+// Отпускание пришло внутри окна дребезга и больше фронтов нет:
+// оно засчитывается по закрытию окна, без нового фронта
+void test_release_inside_debounce_window() {
+  edge(0, LOW);
+  edge(10, HIGH);
+  assertGestures(pollAt(20), {});
+  TEST_ASSERT_EQUAL_UINT64(atUs(Config::Input::DEBOUNCE_MS), ButtonInput::nextDeadlineUs());
+
+  const std::vector<ButtonInput::Event> events = pollAt(Config::Input::DEBOUNCE_MS + 30);
+  assertGestures(events, {Gesture::ShortPress});
+  TEST_ASSERT_EQUAL_UINT64(atUs(Config::Input::DEBOUNCE_MS), events[0].edgeUs);
+}
+
+// Фронтов больше, чем вмещает кольцо: лишние считаются потерянными,
+// а уровень берётся с входа, так что нажатие не залипает
+void test_overflow_counts_dropped_edges() {
+  const uint32_t droppedBefore = ButtonInput::latencyStats().droppedEdges;
+  const uint32_t edges         = EDGE_CAPACITY + 9;
+
+  moveTo(0);
+  for (uint32_t i = 0; i < edges; ++i) {
+    HostPins::setInput(PIN, (i % 2 == 0) ? LOW : HIGH);
+    VirtualClock::advanceUs(10);
+  }
+  TEST_ASSERT_EQUAL_UINT32(edges - EDGE_CAPACITY, ButtonInput::latencyStats().droppedEdges - droppedBefore);
+
+  // Последний фронт - нажатие (нечётное число фронтов): кнопка зажата
+  assertGestures(pollAt(10), {});
+  edge(100, HIGH);
+  assertGestures(pollAt(200), {Gesture::ShortPress});
+}
+
+int main(int argc, char** argv) {
+  ButtonInput::begin(PIN);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_short_press);
+  RUN_TEST(test_long_press);
+  RUN_TEST(test_double_click);
+  RUN_TEST(test_slow_clicks_stay_short);
+  RUN_TEST(test_bounce_is_one_press);
+  RUN_TEST(test_release_inside_debounce_window);
+  RUN_TEST(test_overflow_counts_dropped_edges);
+  return UNITY_END();
+}
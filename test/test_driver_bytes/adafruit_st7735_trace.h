@@ -0,0 +1,116 @@
+#pragma once
+
+// ----------------------------------------------------------
+// Эталонный поток байт Adafruit_ST7735 1.10.x (BLACKTAB) на тех
+// же вызовах, что и в test_main.cpp: то, что библиотека выдаёт на
+// шину из таблиц Rcmd1/Rcmd2red/Rcmd3, setRotation и
+// Adafruit_SPITFT (setAddrWindow, writeColor, writePixels).
+// Пересобирать из драйвера нельзя - иначе тест сравнит его с собой.
+// Задержки initR в поток не попадают.
+//
+// Строка - одна посылка:
+//   C xx          байт команды (DC = 0)
+//   D xx xx ...   байты параметров (DC = 1)
+//   P cccc*n      n пикселей цвета cccc (big-endian на проводе)
+// ----------------------------------------------------------
+
+inline constexpr const char* ADAFRUIT_ST7735_TRACE = R"trace(
+# initR(INITR_BLACKTAB): Rcmd1
+C 01
+C 11
+C B1
+D 01 2C 2D
+C B2
+D 01 2C 2D
+C B3
+D 01 2C 2D 01 2C 2D
+C B4
+D 07
+C C0
+D A2 02 84
+C C1
+D C5
+C C2
+D 0A 00
+C C3
+D 8A 2A
+C C4
+D 8A EE
+C C5
+D 0E
+C 20
+C 36
+D C8
+C 3A
+D 05
+# Rcmd2red
+C 2A
+D 00 00 00 7F
+C 2B
+D 00 00 00 9F
+# Rcmd3
+C E0
+D 02 1C 07 12 37 32 29 2D 29 25 2B 39 00 01 03 10
+C E1
+D 03 1D 07 06 2E 2C 29 2D 2E 2E 37 3F 00 00 02 10
+C 13
+C 29
+# BLACKTAB: порядок цветов RGB
+C 36
+D C0
+# setRotation(0) в конце initR
+C 36
+D C0
+
+# setRotation(1)
+C 36
+D A0
+
+# fillScreen(0x0000)
+C 2A
+D 00 00 00 9F
+C 2B
+D 00 00 00 7F
+C 2C
+P 0000*20480
+
+# fillRect(10, 20, 30, 8, 0xF800)
+C 2A
+D 00 0A 00 27
+C 2B
+D 00 14 00 1B
+C 2C
+P F800*240
+
+# fillRect(150, 120, 20, 20, 0x001F): отсечение до 10x8
+C 2A
+D 00 96 00 9F
+C 2B
+D 00 78 00 7F
+C 2C
+P 001F*80
+
+# setAddrWindow(5, 6, 3, 2) + writePixels(6 пикселей)
+C 2A
+D 00 05 00 07
+C 2B
+D 00 06 00 07
+C 2C
+P 0001*1
+P 1234*1
+P FFFF*1
+P 8000*1
+P 00F0*1
+P ABCD*1
+
+# drawPixel(159, 127, 0x07E0); drawPixel(160, 0, ...) вне экрана - ничего
+C 2A
+D 00 9F 00 9F
+C 2B
+D 00 7F 00 7F
+C 2C
+P 07E0*1
+
+# invertDisplay(true)
+C 21
+)trace";
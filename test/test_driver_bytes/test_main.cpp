@@ -0,0 +1,117 @@
+#include <unity.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <Adafruit_ST7735.h>
+
+#include "adafruit_st7735_trace.h"
+#include "mock_tft_bus.h"
+#include "st7735_display.h"
+
+// ----------------------------------------------------------
+// Поток байт St7735Display против эталона Adafruit_ST7735
+// ----------------------------------------------------------
+
+namespace {
+
+// Разбор текстовой трассы (формат - в adafruit_st7735_trace.h)
+std::vector<MockTftBus::Byte> parseTrace(const char* text) {
+  std::vector<MockTftBus::Byte> bytes;
+  while (*text != '\0') {
+    const char* end = strchr(text, '\n');
+    if (end == nullptr) {
+      end = text + strlen(text);
+    }
+    const char kind = *text;
+    const char* cursor = text + 1;
+    char* next = nullptr;
+
+    if (kind == 'C' || kind == 'D') {
+      for (unsigned long value = strtoul(cursor, &next, 16); next != cursor && next <= end;
+           value = strtoul(cursor, &next, 16)) {
+        bytes.push_back({kind == 'C', static_cast<uint8_t>(value)});
+        cursor = next;
+      }
+    } else if (kind == 'P') {
+      const unsigned long color = strtoul(cursor, &next, 16);
+      const unsigned long count = strtoul(next + 1, nullptr, 10); // после '*'
+      for (unsigned long i = 0; i < count; ++i) {
+        bytes.push_back({false, static_cast<uint8_t>(color >> 8)});
+        bytes.push_back({false, static_cast<uint8_t>(color & 0xFF)});
+      }
+    }
+    text = *end == '\0' ? end : end + 1;
+  }
+  return bytes;
+}
+
+void replay(St7735Display& display) {
+  display.initR(INITR_BLACKTAB);
+  display.setRotation(1);
+  display.fillScreen(0x0000);
+  display.fillRect(10, 20, 30, 8, 0xF800);
+  display.fillRect(150, 120, 20, 20, 0x001F);
+
+  const uint16_t pixels[] = {0x0001, 0x1234, 0xFFFF, 0x8000, 0x00F0, 0xABCD};
+  display.setAddrWindow(5, 6, 3, 2);
+  display.pushPixels(pixels, sizeof(pixels) / sizeof(pixels[0]));
+
+  display.drawPixel(159, 127, 0x07E0);
+  display.drawPixel(160, 0, 0x07E0);
+  display.invertDisplay(true);
+}
+
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_trace_matches_adafruit() {
+  MockTftBus bus;
+  St7735Display display(bus);
+  replay(display);
+  display.flush();
+
+  const std::vector<MockTftBus::Byte> expected = parseTrace(ADAFRUIT_ST7735_TRACE);
+  const size_t common = expected.size() < bus.bytes.size() ? expected.size() : bus.bytes.size();
+  for (size_t i = 0; i < common; ++i) {
+    if (!(bus.bytes[i] == expected[i])) {
+      char message[96];
+      snprintf(message, sizeof(message), "byte %u: expected %c %02X, got %c %02X", static_cast<unsigned>(i),
+               expected[i].command ? 'C' : 'D', expected[i].value, bus.bytes[i].command ? 'C' : 'D',
+               bus.bytes[i].value);
+      TEST_FAIL_MESSAGE(message);
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(expected.size(), bus.bytes.size());
+}
+
+// Эмуляция панели разбирает тот же поток: пиксели легли по окнам
+void test_panel_receives_pixels() {
+  MockTftBus bus;
+  St7735Display display(bus);
+  replay(display);
+
+  TEST_ASSERT_EQUAL_UINT32(1, bus.resetCount);
+  TEST_ASSERT_TRUE(bus.displayOn);
+  TEST_ASSERT_TRUE(bus.inverted);
+  TEST_ASSERT_EQUAL_HEX8(0xA0, bus.madctl);
+  TEST_ASSERT_EQUAL_HEX16(0x0000, bus.visible(0, 0));
+  TEST_ASSERT_EQUAL_HEX16(0xF800, bus.visible(10, 20));
+  TEST_ASSERT_EQUAL_HEX16(0xF800, bus.visible(39, 27));
+  TEST_ASSERT_EQUAL_HEX16(0x0000, bus.visible(40, 27));
+  TEST_ASSERT_EQUAL_HEX16(0x001F, bus.visible(159, 120));
+  TEST_ASSERT_EQUAL_HEX16(0xABCD, bus.visible(7, 7));
+  TEST_ASSERT_EQUAL_HEX16(0x07E0, bus.visible(159, 127));
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_trace_matches_adafruit);
+  RUN_TEST(test_panel_receives_pixels);
+  return UNITY_END();
+}
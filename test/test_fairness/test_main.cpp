@@ -0,0 +1,40 @@
+#include <unity.h>
+
+#include <stdint.h>
+
+#include "fairness_bench.h"
+
+// ----------------------------------------------------------
+// Проверка честности бросков (то же, что program --fairness N)
+// на размере, посильном для CI. Засев фиксирован, так что прогон
+// повторяем: провал - это изменение генератора или приведения к
+// диапазону, а не неудачная случайность.
+// ----------------------------------------------------------
+
+namespace {
+
+constexpr uint64_t ROLLS = 4000000;
+constexpr uint64_t SEED  = 0x1CED1CEULL;
+
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+// Потоков - по числу ядер, как у program --fairness
+void test_fairness_default_threads() {
+  TEST_ASSERT_EQUAL_INT(0, FairnessBench::run(ROLLS, 0, true, SEED));
+}
+
+// Фиксированное число потоков: одинаковые гистограммы на любой машине
+void test_fairness_four_threads() {
+  TEST_ASSERT_EQUAL_INT(0, FairnessBench::run(ROLLS, 4, true, SEED));
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_fairness_default_threads);
+  RUN_TEST(test_fairness_four_threads);
+  return UNITY_END();
+}
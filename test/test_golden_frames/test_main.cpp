@@ -0,0 +1,179 @@
+#include <unity.h>
+
+#include <Arduino.h>
+#include <Adafruit_ST7735.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "dice_rng.h"
+#include "draw_profiler.h"
+#include "host_scenario.h"
+#include "mock_tft_bus.h"
+#include "renderer.h"
+#include "roll_animation.h"
+
+extern MockTftBus tftDmaBus;
+
+// ----------------------------------------------------------
+// Полный цикл на виртуальных часах: заставка -> бросок ->
+// результат -> таймер -> алерт. Снимки MockTftBus сравниваются с
+// эталонами из golden/, в конце - число примитивов и байт на шине.
+//
+// Прогон один на процесс (см. host_scenario.h): тесты идут по
+// шкале времени в порядке RUN_TEST и продолжают друг друга.
+//
+// Эталоны пересоздаются прогоном с ICEDICE_UPDATE_GOLDEN=1; при
+// расхождении рядом с эталоном кладётся <имя>.actual.ppm.
+// ----------------------------------------------------------
+
+namespace {
+
+constexpr uint64_t      SEED     = 7;
+constexpr unsigned long PRESS_MS = 3000;
+
+constexpr uint16_t WIDTH  = Config::Display::WIDTH;
+constexpr uint16_t HEIGHT = Config::Display::HEIGHT;
+
+std::string goldenPath(const char* name, const char* suffix) {
+  std::string path = __FILE__;
+  path.erase(path.find_last_of("/\\") + 1);
+  return path + "golden/" + name + suffix;
+}
+
+bool loadPpm(const std::string& path, std::vector<uint8_t>& pixels) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  unsigned w = 0;
+  unsigned h = 0;
+  unsigned depth = 0;
+  const bool header = fscanf(file, "P6 %u %u %u", &w, &h, &depth) == 3 && fgetc(file) != EOF;
+  pixels.resize(static_cast<size_t>(w) * h * 3);
+  const bool loaded = header && w == WIDTH && h == HEIGHT && depth == 255 &&
+                      fread(pixels.data(), 1, pixels.size(), file) == pixels.size();
+  fclose(file);
+  return loaded;
+}
+
+// Экран в момент atMs против golden/<name>.ppm
+void checkFrame(unsigned long atMs, const char* name) {
+  HostScenario::runUntil(atMs);
+  Renderer::waitIdle();
+
+  const std::string golden = goldenPath(name, ".ppm");
+  if (getenv("ICEDICE_UPDATE_GOLDEN") != nullptr) {
+    TEST_ASSERT_TRUE(tftDmaBus.savePpm(golden.c_str(), WIDTH, HEIGHT));
+    return;
+  }
+
+  const std::vector<uint8_t> actual = tftDmaBus.rgb(WIDTH, HEIGHT);
+  std::vector<uint8_t> expected;
+  if (!loadPpm(golden, expected)) {
+    tftDmaBus.savePpm(goldenPath(name, ".actual.ppm").c_str(), WIDTH, HEIGHT);
+    TEST_FAIL_MESSAGE(("no golden frame " + golden).c_str());
+  }
+
+  uint32_t differing = 0;
+  size_t   first     = 0;
+  for (size_t i = 0; i < actual.size(); i += 3) {
+    if (actual[i] != expected[i] || actual[i + 1] != expected[i + 1] || actual[i + 2] != expected[i + 2]) {
+      first = differing == 0 ? i / 3 : first;
+      ++differing;
+    }
+  }
+  if (differing > 0) {
+    tftDmaBus.savePpm(goldenPath(name, ".actual.ppm").c_str(), WIDTH, HEIGHT);
+    char message[128];
+    snprintf(message, sizeof(message), "%s: %u pixels differ, first at (%u, %u)", name,
+             static_cast<unsigned>(differing), static_cast<unsigned>(first % WIDTH),
+             static_cast<unsigned>(first / WIDTH));
+    TEST_FAIL_MESSAGE(message);
+  }
+}
+
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_intro_frame() {
+  checkFrame(2000, "intro");
+}
+
+void test_roll_animation_frame() {
+  checkFrame(PRESS_MS + 200, "roll");
+}
+
+void test_roll_result_frame() {
+  checkFrame(5000, "result");
+}
+
+void test_timer_frame() {
+  checkFrame(20000, "timer");
+}
+
+void test_alert_frame() {
+  checkFrame(60000, "alert");
+}
+
+// Стоимость всего цикла: кадры, примитивы по обработчикам и байты на шине
+void test_draw_and_bus_counts() {
+  using DrawProfiler::counters;
+  using DrawProfiler::Handler;
+  using DrawProfiler::Primitive;
+
+  HostScenario::runUntil(70000);
+  Renderer::waitIdle();
+
+  TEST_ASSERT_EQUAL_UINT32(112, Renderer::frameStats().frames);
+  TEST_ASSERT_EQUAL_UINT32(1, RollAnimation::stats().rolls);
+  TEST_ASSERT_EQUAL_UINT32(31, RollAnimation::stats().frames);
+
+  // Заставка - один кадр на весь экран одним окном
+  TEST_ASSERT_EQUAL_UINT32(1, counters(Handler::Intro, Primitive::Flush).windows);
+  TEST_ASSERT_EQUAL_UINT32(WIDTH * HEIGHT * 2, counters(Handler::Intro, Primitive::Flush).pixelBytes);
+
+  TEST_ASSERT_EQUAL_UINT32(64, counters(Handler::DiceAnimation, Primitive::Sprite).calls);
+  TEST_ASSERT_EQUAL_UINT32(32, counters(Handler::DiceAnimation, Primitive::Flush).calls);
+  TEST_ASSERT_EQUAL_UINT32(53, counters(Handler::Timer, Primitive::Glyph).calls);
+  TEST_ASSERT_EQUAL_UINT32(1, counters(Handler::Alert, Primitive::Triangle).calls);
+  TEST_ASSERT_EQUAL_UINT32(32, counters(Handler::Alert, Primitive::Command).calls);
+
+  TEST_ASSERT_EQUAL_UINT64(16727, tftDmaBus.commandBytes);
+  TEST_ASSERT_EQUAL_UINT64(869997, tftDmaBus.dataBytes);
+
+  // Профилировщик видит каждый байт, ушедший на шину
+  uint64_t profiled = 0;
+  for (uint8_t h = 0; h < static_cast<uint8_t>(Handler::COUNT); ++h) {
+    for (uint8_t p = 0; p < static_cast<uint8_t>(Primitive::COUNT); ++p) {
+      const DrawProfiler::Counters& c = counters(static_cast<Handler>(h), static_cast<Primitive>(p));
+      profiled += c.commandBytes + c.paramBytes + c.pixelBytes;
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT64(tftDmaBus.commandBytes + tftDmaBus.dataBytes, profiled);
+}
+
+int main(int argc, char** argv) {
+  tftDmaBus.recording = false;
+  Serial.muted = true;
+
+  HostScenario::press(PRESS_MS, Config::Input::DEBOUNCE_MS * 2);
+  HostScenario::begin(false);
+  DiceRng::seed(SEED);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_intro_frame);
+  RUN_TEST(test_roll_animation_frame);
+  RUN_TEST(test_roll_result_frame);
+  RUN_TEST(test_timer_frame);
+  RUN_TEST(test_alert_frame);
+  RUN_TEST(test_draw_and_bus_counts);
+  return UNITY_END();
+}
@@ -0,0 +1,92 @@
+#include <unity.h>
+
+#include <stdint.h>
+
+#include <thread>
+
+#include "spsc_ring.h"
+
+// ----------------------------------------------------------
+// SpscRing между двумя std::thread: писатель кладёт номера подряд,
+// читатель проверяет, что каждый пришёл ровно один раз и по порядку.
+// Маленькое кольцо заставляет обе стороны часто упираться в
+// полный и пустой буфер, а элемент шире слова ловит чтение
+// наполовину записанного.
+// ----------------------------------------------------------
+
+namespace {
+
+constexpr uint32_t ITEMS = 1000000;
+
+struct Item {
+  uint32_t sequence;
+  uint32_t check; // ~sequence: рассогласование - порванная запись
+};
+
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_single_thread_fill_and_drain() {
+  SpscRing<Item, 8> ring;
+  TEST_ASSERT_TRUE(ring.empty());
+  for (uint32_t i = 0; i < ring.capacity(); ++i) {
+    TEST_ASSERT_TRUE(ring.push({i, ~i}));
+  }
+  TEST_ASSERT_FALSE(ring.push({99, ~99u}));
+  TEST_ASSERT_EQUAL_UINT32(ring.capacity(), ring.size());
+
+  Item item;
+  for (uint32_t i = 0; i < ring.capacity(); ++i) {
+    TEST_ASSERT_TRUE(ring.pop(item));
+    TEST_ASSERT_EQUAL_UINT32(i, item.sequence);
+  }
+  TEST_ASSERT_FALSE(ring.pop(item));
+  TEST_ASSERT_TRUE(ring.empty());
+}
+
+void test_two_threads_keep_order() {
+  SpscRing<Item, 16> ring;
+
+  std::thread producer([&ring] {
+    for (uint32_t i = 0; i < ITEMS;) {
+      if (ring.push({i, ~i})) {
+        ++i;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint32_t expected = 0;
+  uint32_t received = 0;
+  uint32_t outOfOrder = 0; // пропуск или повтор номера
+  uint32_t torn = 0;
+  while (expected < ITEMS) {
+    Item item;
+    if (!ring.pop(item)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ++received;
+    outOfOrder += item.sequence != expected ? 1 : 0;
+    torn       += item.check != ~item.sequence ? 1 : 0;
+    expected    = item.sequence + 1;
+  }
+  producer.join();
+
+  TEST_ASSERT_EQUAL_UINT32(0, outOfOrder);
+  TEST_ASSERT_EQUAL_UINT32(0, torn);
+  TEST_ASSERT_EQUAL_UINT32(ITEMS, received);
+  TEST_ASSERT_EQUAL_UINT32(ITEMS, expected);
+  TEST_ASSERT_TRUE(ring.empty());
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_single_thread_fill_and_drain);
+  RUN_TEST(test_two_threads_keep_order);
+  return UNITY_END();
+}